@@ -29,5 +29,65 @@ else()
   endif()
 endif()
 
+if(BUILD_MQT_DDVIS_BENCHMARKS)
+  # cmake-format: off
+  set(BENCHMARK_VERSION 1.8.5
+      CACHE STRING "Google Benchmark version")
+  # cmake-format: on
+  set(BENCHMARK_ENABLE_TESTING
+      OFF
+      CACHE BOOL "Build the tests of Google Benchmark")
+  set(BENCHMARK_ENABLE_INSTALL
+      OFF
+      CACHE BOOL "Install Google Benchmark")
+  if(CMAKE_VERSION VERSION_GREATER_EQUAL 3.24)
+    FetchContent_Declare(
+      benchmark
+      GIT_REPOSITORY https://github.com/google/benchmark.git
+      GIT_TAG v${BENCHMARK_VERSION}
+      FIND_PACKAGE_ARGS ${BENCHMARK_VERSION})
+    list(APPEND FETCH_PACKAGES benchmark)
+  else()
+    find_package(benchmark ${BENCHMARK_VERSION} QUIET)
+    if(NOT benchmark_FOUND)
+      FetchContent_Declare(
+        benchmark
+        GIT_REPOSITORY https://github.com/google/benchmark.git
+        GIT_TAG v${BENCHMARK_VERSION})
+      list(APPEND FETCH_PACKAGES benchmark)
+    endif()
+  endif()
+endif()
+
+if(BUILD_MQT_DDVIS_TESTS)
+  # cmake-format: off
+  set(GTEST_VERSION 1.15.2
+      CACHE STRING "Google Test version")
+  # cmake-format: on
+  set(INSTALL_GTEST
+      OFF
+      CACHE BOOL "Install Google Test")
+  set(gtest_force_shared_crt
+      ON
+      CACHE BOOL "Use the shared runtime of MSVC for Google Test")
+  if(CMAKE_VERSION VERSION_GREATER_EQUAL 3.24)
+    FetchContent_Declare(
+      googletest
+      GIT_REPOSITORY https://github.com/google/googletest.git
+      GIT_TAG v${GTEST_VERSION}
+      FIND_PACKAGE_ARGS ${GTEST_VERSION} NAMES GTest)
+    list(APPEND FETCH_PACKAGES googletest)
+  else()
+    find_package(GTest ${GTEST_VERSION} QUIET)
+    if(NOT GTest_FOUND)
+      FetchContent_Declare(
+        googletest
+        GIT_REPOSITORY https://github.com/google/googletest.git
+        GIT_TAG v${GTEST_VERSION})
+      list(APPEND FETCH_PACKAGES googletest)
+    endif()
+  endif()
+endif()
+
 # Make all declared dependencies available.
 FetchContent_MakeAvailable(${FETCH_PACKAGES})
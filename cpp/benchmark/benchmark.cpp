@@ -0,0 +1,437 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+/* Benchmarks of the stepping engines behind QDDVis and QDDVer. They drive the
+ * same load/step/seek/export logic as the N-API wrappers, so regressions show
+ * up before deploying instead of only in the browser.
+ *
+ * The circuits are the samples of the web interface (cpp/sample_qasm) and
+ * generated QFT, Grover and random circuits of increasing size. Every
+ * benchmark is named <Engine>/<Operation>/<Circuit>, so a single aspect can be
+ * selected with --benchmark_filter, e.g., --benchmark_filter=Simulation/ToLine
+ */
+
+#include "CircuitCache.h"
+#include "SimulationEngine.h"
+#include "VerificationEngine.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef SAMPLE_QASM_DIR
+#define SAMPLE_QASM_DIR "cpp/sample_qasm"
+#endif
+
+namespace {
+// format code of OpenQASM (see SimulationEngine::load)
+constexpr unsigned int QASM = 1;
+
+struct Circuit {
+  std::string name{};
+  std::string algo{};
+  // whether the verification benchmarks use the circuit, which requires it to
+  // be unitary and its functionality to stay manageable
+  bool verify = false;
+};
+
+/**
+ * @return the circuits of the web interface, sorted by name
+ */
+std::vector<Circuit> sampleCircuits() {
+  std::vector<Circuit>        circuits{};
+  const std::filesystem::path directory{SAMPLE_QASM_DIR};
+  if (!std::filesystem::is_directory(directory))
+    return circuits;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.path().extension() != ".qasm")
+      continue;
+    std::ifstream     file{entry.path()};
+    std::stringstream ss{};
+    ss << file.rdbuf();
+    // the samples end with measurements
+    circuits.push_back({entry.path().stem().string(), ss.str(), false});
+  }
+  std::sort(circuits.begin(), circuits.end(),
+            [](const Circuit& lhs, const Circuit& rhs) {
+              return lhs.name < rhs.name;
+            });
+  return circuits;
+}
+
+std::string header(const std::size_t nqubits) {
+  std::stringstream ss{};
+  ss << "OPENQASM 3.0;\ninclude \"stdgates.inc\";\nqubit[" << nqubits
+     << "] q;\n";
+  return ss.str();
+}
+
+Circuit qft(const std::size_t nqubits) {
+  std::stringstream ss{};
+  ss << header(nqubits);
+  for (std::size_t i = nqubits; i-- > 0;) {
+    ss << "h q[" << i << "];\n";
+    for (std::size_t j = i; j-- > 0;)
+      ss << "cp(pi/" << (std::uint64_t{1} << (i - j)) << ") q[" << j << "], q["
+         << i << "];\n";
+  }
+  for (std::size_t i = 0; i < nqubits / 2; ++i)
+    ss << "swap q[" << i << "], q[" << nqubits - 1 - i << "];\n";
+  return {"QFT (" + std::to_string(nqubits) + " qubits)", ss.str(),
+          nqubits <= 16};
+}
+
+/**Grover search for the all-ones state with the optimal number of
+ * iterations.
+ */
+Circuit grover(const std::size_t nqubits) {
+  std::stringstream controlledZ{};
+  controlledZ << "ctrl(" << nqubits - 1 << ") @ z";
+  for (std::size_t i = 0; i < nqubits; ++i)
+    controlledZ << (i == 0 ? " " : ", ") << "q[" << i << "]";
+  controlledZ << ";\n";
+
+  const auto pi = std::acos(-1.);
+  const auto iterations =
+      static_cast<std::size_t>(pi / 4. * std::sqrt(std::pow(2., nqubits)));
+  std::stringstream ss{};
+  ss << header(nqubits) << "h q;\n";
+  for (std::size_t i = 0; i < iterations; ++i) {
+    ss << controlledZ.str(); // oracle
+    ss << "h q;\nx q;\n" << controlledZ.str() << "x q;\nh q;\n"; // diffusion
+  }
+  return {"Grover (" + std::to_string(nqubits) + " qubits)", ss.str(), true};
+}
+
+/**Layers of random single-qubit gates, each followed by CNOTs between random
+ * pairs of qubits. The generator is seeded with the size, so the circuits are
+ * the same in every run.
+ */
+Circuit randomCircuit(const std::size_t nqubits, const std::size_t depth) {
+  std::mt19937_64                            generator{nqubits * depth};
+  std::uniform_int_distribution<std::size_t> gate{0, 5};
+  std::uniform_real_distribution<double>     angle{0., 2. * std::acos(-1.)};
+  std::vector<std::size_t>                   qubits(nqubits);
+  for (std::size_t i = 0; i < nqubits; ++i)
+    qubits[i] = i;
+
+  std::stringstream ss{};
+  ss << header(nqubits);
+  for (std::size_t layer = 0; layer < depth; ++layer) {
+    for (std::size_t i = 0; i < nqubits; ++i) {
+      switch (gate(generator)) {
+      case 0:
+        ss << "h";
+        break;
+      case 1:
+        ss << "x";
+        break;
+      case 2:
+        ss << "s";
+        break;
+      case 3:
+        ss << "t";
+        break;
+      case 4:
+        ss << "sx";
+        break;
+      default:
+        ss << "rz(" << angle(generator) << ")";
+      }
+      ss << " q[" << i << "];\n";
+    }
+    std::shuffle(qubits.begin(), qubits.end(), generator);
+    for (std::size_t i = 0; i + 1 < nqubits; i += 2)
+      ss << "cx q[" << qubits[i] << "], q[" << qubits[i + 1] << "];\n";
+  }
+  // the functionality of larger random circuits is too large to be built
+  return {"Random (" + std::to_string(nqubits) + " qubits, depth " +
+              std::to_string(depth) + ")",
+          ss.str(), nqubits <= 8};
+}
+
+std::vector<Circuit> generatedCircuits() {
+  std::vector<Circuit> circuits{};
+  for (const std::size_t nqubits : {8U, 16U, 32U, 64U})
+    circuits.push_back(qft(nqubits));
+  for (const std::size_t nqubits : {6U, 8U, 10U, 12U})
+    circuits.push_back(grover(nqubits));
+  for (const std::size_t nqubits : {8U, 12U, 16U})
+    circuits.push_back(randomCircuit(nqubits, 8 * nqubits));
+  return circuits;
+}
+
+/**Applies the operations of the loaded circuit until the end or the first
+ * measurement or reset (toEnd stops at barriers, too).
+ *
+ * @return the position after the applied operations
+ */
+unsigned int simulateToEnd(SimulationEngine& engine) {
+  unsigned long long nops = 0;
+  while (true) {
+    const auto result = engine.toEnd();
+    nops += result.nops;
+    if (!result.changed || !result.barrier)
+      break;
+  }
+  return static_cast<unsigned int>(nops);
+}
+
+void verifyToEnd(VerificationEngine& engine, const bool algo1) {
+  while (true) {
+    const auto result = engine.toEnd(algo1);
+    if (!result.changed || !result.barrier)
+      break;
+  }
+}
+
+/**Runs the benchmark body and reports exceptions of the engines as errors of
+ * the benchmark instead of aborting all remaining benchmarks.
+ */
+template <class Body> void guarded(benchmark::State& state, Body body) {
+  try {
+    body();
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void registerSimulation(const Circuit& circuit) {
+  const auto name = [&circuit](const std::string& operation) {
+    return "Simulation/" + operation + "/" + circuit.name;
+  };
+  const auto& algo = circuit.algo;
+
+  // parsing the circuit and acquiring a package (without the circuit cache)
+  benchmark::RegisterBenchmark(
+      name("Load").c_str(), [algo](benchmark::State& state) {
+        guarded(state, [&]() {
+          std::unique_ptr<SimulationEngine> engine{};
+          for (auto _ : state) {
+            state.PauseTiming();
+            CircuitCache::instance().clear();
+            engine = std::make_unique<SimulationEngine>();
+            state.ResumeTiming();
+            const auto lock   = engine->lock();
+            auto       result = engine->load(algo, QASM, 0, true);
+            benchmark::DoNotOptimize(result);
+          }
+        });
+      });
+
+  benchmark::RegisterBenchmark(
+      name("ToEnd").c_str(), [algo](benchmark::State& state) {
+        guarded(state, [&]() {
+          SimulationEngine engine{};
+          const auto       lock = engine.lock();
+          engine.load(algo, QASM, 0, true);
+          for (auto _ : state) {
+            state.PauseTiming();
+            engine.toStart();
+            state.ResumeTiming();
+            auto nops = simulateToEnd(engine);
+            benchmark::DoNotOptimize(nops);
+          }
+        });
+      });
+
+  // seeking back and forth between the middle and the end
+  benchmark::RegisterBenchmark(
+      name("ToLine").c_str(), [algo](benchmark::State& state) {
+        guarded(state, [&]() {
+          SimulationEngine engine{};
+          const auto       lock = engine.lock();
+          engine.load(algo, QASM, 0, true);
+          const auto end      = simulateToEnd(engine);
+          bool       toMiddle = true;
+          for (auto _ : state) {
+            auto result = engine.toLine(toMiddle ? end / 2 : end);
+            benchmark::DoNotOptimize(result);
+            toMiddle = !toMiddle;
+          }
+        });
+      });
+
+  // exporting the DD after a step (the export of a state is cached, so every
+  // iteration exports the state at another position)
+  benchmark::RegisterBenchmark(
+      name("GetDD").c_str(), [algo](benchmark::State& state) {
+        guarded(state, [&]() {
+          SimulationEngine engine{};
+          const auto       lock = engine.lock();
+          engine.load(algo, QASM, 0, true);
+          const auto   end = std::max(simulateToEnd(engine), 1U);
+          const auto   options  = SimulationEngine::AmplitudeOptions{
+              SimulationEngine::AmplitudeMode::Dense, 0};
+          unsigned int position = 0;
+          for (auto _ : state) {
+            state.PauseTiming();
+            position = position % end + 1;
+            engine.toLine(position);
+            state.ResumeTiming();
+            auto result = engine.getDD(options);
+            benchmark::DoNotOptimize(result);
+          }
+        });
+      });
+
+  // the export of the final state is cached after the first iteration, so
+  // these mostly measure the amplitude extraction
+  for (const auto mode : {SimulationEngine::AmplitudeMode::Dense,
+                          SimulationEngine::AmplitudeMode::Sparse,
+                          SimulationEngine::AmplitudeMode::TopK}) {
+    const std::string label =
+        mode == SimulationEngine::AmplitudeMode::Dense    ? "Dense"
+        : mode == SimulationEngine::AmplitudeMode::Sparse ? "Sparse"
+                                                          : "TopK";
+    const auto options = SimulationEngine::defaultAmplitudeOptions(mode);
+    benchmark::RegisterBenchmark(
+        name("Amplitudes" + label).c_str(),
+        [algo, options](benchmark::State& state) {
+          guarded(state, [&]() {
+            SimulationEngine engine{};
+            const auto       lock = engine.lock();
+            engine.load(algo, QASM, 0, true);
+            simulateToEnd(engine);
+            for (auto _ : state) {
+              auto result = engine.getDD(options);
+              benchmark::DoNotOptimize(result);
+            }
+          });
+        });
+  }
+}
+
+/**Registers the benchmarks of the verification engine, which compare the
+ * circuit with itself.
+ */
+void registerVerification(const Circuit& circuit) {
+  const auto name = [&circuit](const std::string& operation) {
+    return "Verification/" + operation + "/" + circuit.name;
+  };
+  // loads the circuit as both algorithms and returns its number of operations
+  const auto load = [algo = circuit.algo](VerificationEngine& engine) {
+    engine.load(algo, QASM, 0, true, true);
+    return static_cast<unsigned int>(engine.load(algo, QASM, 0, true, false));
+  };
+
+  benchmark::RegisterBenchmark(
+      name("Load").c_str(), [load](benchmark::State& state) {
+        guarded(state, [&]() {
+          std::unique_ptr<VerificationEngine> engine{};
+          for (auto _ : state) {
+            state.PauseTiming();
+            CircuitCache::instance().clear();
+            engine = std::make_unique<VerificationEngine>();
+            state.ResumeTiming();
+            const auto lock = engine->lock();
+            auto       nops = load(*engine);
+            benchmark::DoNotOptimize(nops);
+          }
+        });
+      });
+
+  // the functionality of algo1 followed by the inverse of algo2
+  benchmark::RegisterBenchmark(
+      name("ToEnd").c_str(), [load](benchmark::State& state) {
+        guarded(state, [&]() {
+          VerificationEngine engine{};
+          const auto         lock = engine.lock();
+          load(engine);
+          for (auto _ : state) {
+            state.PauseTiming();
+            engine.toStart(true);
+            engine.toStart(false);
+            state.ResumeTiming();
+            verifyToEnd(engine, true);
+            verifyToEnd(engine, false);
+          }
+        });
+      });
+
+  // seeking algo2 back and forth between the middle and the end
+  benchmark::RegisterBenchmark(
+      name("ToLine").c_str(), [load](benchmark::State& state) {
+        guarded(state, [&]() {
+          VerificationEngine engine{};
+          const auto         lock = engine.lock();
+          const auto         nops = load(engine);
+          verifyToEnd(engine, true);
+          bool toMiddle = true;
+          for (auto _ : state) {
+            auto changed = engine.toLine(toMiddle ? nops / 2 : nops, false);
+            benchmark::DoNotOptimize(changed);
+            toMiddle = !toMiddle;
+          }
+        });
+      });
+
+  benchmark::RegisterBenchmark(
+      name("GetDD").c_str(), [load](benchmark::State& state) {
+        guarded(state, [&]() {
+          VerificationEngine engine{};
+          const auto         lock     = engine.lock();
+          const auto         end      = std::max(load(engine), 1U);
+          unsigned int       position = 0;
+          for (auto _ : state) {
+            state.PauseTiming();
+            position = position % end + 1;
+            engine.toLine(position, true);
+            state.ResumeTiming();
+            auto dot = engine.getDD();
+            benchmark::DoNotOptimize(dot);
+          }
+        });
+      });
+
+  benchmark::RegisterBenchmark(
+      name("CheckEquivalence").c_str(), [load](benchmark::State& state) {
+        guarded(state, [&]() {
+          VerificationEngine engine{};
+          const auto         lock = engine.lock();
+          load(engine);
+          for (auto _ : state) {
+            state.PauseTiming();
+            engine.toStart(true);
+            engine.toStart(false);
+            state.ResumeTiming();
+            auto result = engine.checkEquivalence(
+                VerificationEngine::Strategy::Proportional);
+            benchmark::DoNotOptimize(result);
+          }
+        });
+      });
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  auto circuits = sampleCircuits();
+  for (auto& circuit : generatedCircuits())
+    circuits.push_back(std::move(circuit));
+  for (const auto& circuit : circuits) {
+    registerSimulation(circuit);
+    if (circuit.verify)
+      registerVerification(circuit);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef ASYNCTASK_H
+#define ASYNCTASK_H
+
+#include <exception>
+#include <functional>
+#include <napi.h>
+#include <utility>
+
+/**Runs a task on the libuv thread pool and settles a Promise with its result.
+ * The task must not touch any N-API values; the conversion of its result to a
+ * JavaScript value happens on the main thread once it has finished.
+ * Exceptions thrown by the task reject the Promise with their message.
+ *
+ * The JavaScript object that issued the task is referenced until the task has
+ * finished, so the native object it wraps stays alive in the meantime.
+ */
+template <class Result> class AsyncTask : public Napi::AsyncWorker {
+public:
+  using Task      = std::function<Result()>;
+  using Converter = std::function<Napi::Value(Napi::Env, Result&)>;
+
+  /**Creates the task and queues it for execution.
+   *
+   * @param self the object the task works on
+   * @param task the work to perform on a worker thread
+   * @param convert converts the result into a JavaScript value
+   * @return a Promise that is settled once the task has finished
+   */
+  static Napi::Promise Queue(const Napi::Object& self, Task task,
+                             Converter convert) {
+    auto* worker =
+        new AsyncTask(self.Env(), self, std::move(task), std::move(convert));
+    auto promise = worker->deferred.Promise();
+    worker->Napi::AsyncWorker::Queue(); // deletes itself after completion
+    return promise;
+  }
+
+protected:
+  void Execute() override {
+    try {
+      result = task();
+    } catch (const std::exception& e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override {
+    Napi::HandleScope scope(Env());
+    deferred.Resolve(convert(Env(), result));
+  }
+
+  void OnError(const Napi::Error& e) override { deferred.Reject(e.Value()); }
+
+private:
+  AsyncTask(Napi::Env env, const Napi::Object& self, Task task,
+            Converter convert)
+      : Napi::AsyncWorker(env), deferred(Napi::Promise::Deferred::New(env)),
+        self(Napi::Persistent(self)), task(std::move(task)),
+        convert(std::move(convert)) {}
+
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference   self;
+  Task                    task;
+  Converter               convert;
+  Result                  result{};
+};
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "CircuitCache.h"
+
+#include <functional>
+#include <istream>
+#include <streambuf>
+#include <utility>
+
+namespace {
+/**Read-only stream buffer over a string, so algorithms do not have to be
+ * copied into a std::stringstream before they are parsed.
+ */
+class StringBuffer : public std::streambuf {
+public:
+  explicit StringBuffer(const std::string& str) {
+    // the buffer never writes, so casting away const is safe
+    auto* data = const_cast<char*>(str.data());
+    setg(data, data, data + str.size());
+  }
+
+protected:
+  pos_type seekoff(const off_type off, const std::ios_base::seekdir dir,
+                   const std::ios_base::openmode which) override {
+    if ((which & std::ios_base::out) != 0)
+      return pos_type(off_type(-1));
+    char* base = gptr();
+    if (dir == std::ios_base::beg)
+      base = eback();
+    else if (dir == std::ios_base::end)
+      base = egptr();
+    if (off < eback() - base || off > egptr() - base)
+      return pos_type(off_type(-1));
+    setg(eback(), base + off, egptr());
+    return pos_type(gptr() - eback());
+  }
+
+  pos_type seekpos(const pos_type pos,
+                   const std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+} // namespace
+
+CircuitCache& CircuitCache::instance() {
+  static CircuitCache cache{};
+  return cache;
+}
+
+std::unique_ptr<qc::QuantumComputation>
+CircuitCache::import(const std::string& algo, const qc::Format format) {
+  const Key key{std::hash<std::string>{}(algo), format};
+  std::shared_ptr<const qc::QuantumComputation> cached{};
+  {
+    std::lock_guard guard{mutex};
+    if (const auto it = index.find(key);
+        it != index.end() && it->second->algo == algo) {
+      entries.splice(entries.begin(), entries, it->second);
+      cached = it->second->circuit;
+      ++hits;
+    } else {
+      ++misses;
+    }
+  }
+  // cached circuits are never modified, so they can be copied without holding
+  // the lock
+  if (cached)
+    return std::make_unique<qc::QuantumComputation>(*cached);
+
+  // parsing may take a while, so it happens outside the lock; if the same text
+  // is parsed concurrently, the last result is kept
+  StringBuffer buffer{algo};
+  std::istream is{&buffer};
+  auto         circuit = std::make_unique<qc::QuantumComputation>();
+  circuit->import(is, format);
+
+  // huge texts are not kept, since the cache stores a copy of the text
+  if (algo.size() <= MAX_TEXT_SIZE) {
+    std::lock_guard guard{mutex};
+    insert({key, algo, std::make_shared<qc::QuantumComputation>(*circuit)});
+  }
+  return circuit;
+}
+
+void CircuitCache::clear() {
+  std::lock_guard guard{mutex};
+  entries.clear();
+  index.clear();
+  cachedOperations = 0;
+}
+
+CircuitCache::Stats CircuitCache::stats() {
+  std::lock_guard guard{mutex};
+  return {entries.size(), cachedOperations, hits, misses};
+}
+
+/**Adds the entry as the most recently used one, replacing an entry with the
+ * same key, and evicts the least recently used entries beyond the budget.
+ * Circuits that exceed the budget on their own are not cached.
+ */
+void CircuitCache::insert(Entry entry) {
+  const auto operations = entry.circuit->getNops();
+  if (operations > maxOperations)
+    return;
+
+  if (const auto it = index.find(entry.key); it != index.end()) {
+    cachedOperations -= it->second->circuit->getNops();
+    entries.erase(it->second);
+    index.erase(it);
+  }
+  entries.push_front(std::move(entry));
+  index.emplace(entries.front().key, entries.begin());
+  cachedOperations += operations;
+
+  while (cachedOperations > maxOperations) {
+    const auto& last = entries.back();
+    cachedOperations -= last.circuit->getNops();
+    index.erase(last.key);
+    entries.pop_back();
+  }
+}
+
+std::size_t unchangedOperations(const qc::QuantumComputation& before,
+                                const qc::QuantumComputation& after) {
+  if (before.getNqubits() != after.getNqubits())
+    return 0;
+  std::size_t unchanged = 0;
+  auto        beforeIt  = before.begin();
+  auto        afterIt   = after.begin();
+  while (beforeIt != before.end() && afterIt != after.end() &&
+         (*beforeIt)->equals(**afterIt)) {
+    ++beforeIt;
+    ++afterIt;
+    ++unchanged;
+  }
+  return unchanged;
+}
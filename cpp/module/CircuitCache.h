@@ -0,0 +1,100 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef CIRCUITCACHE_H
+#define CIRCUITCACHE_H
+
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**Process-wide cache of parsed circuits, keyed by a hash of the algorithm text
+ * and its format. Sessions loading the same text (e.g., an example algorithm or
+ * a re-submission) get a copy of the cached circuit instead of parsing it
+ * again. Copying a circuit is linear in its number of operations, which is far
+ * cheaper than parsing.
+ *
+ * The summed number of operations of all entries is bounded; the least recently
+ * used entries are evicted first.
+ */
+class CircuitCache {
+public:
+  static constexpr std::size_t DEFAULT_MAX_OPERATIONS = 1U << 20U;
+
+  // maximum length of an algorithm text that is cached
+  static constexpr std::size_t MAX_TEXT_SIZE = 1U << 24U;
+
+  struct Stats {
+    std::size_t entries    = 0;
+    std::size_t operations = 0;
+    std::size_t hits       = 0;
+    std::size_t misses     = 0;
+  };
+
+  static CircuitCache& instance();
+
+  CircuitCache(const CircuitCache&)            = delete;
+  CircuitCache& operator=(const CircuitCache&) = delete;
+
+  /**Returns a copy of the parsed circuit and parses it only if it is not
+   * cached yet.
+   *
+   * @throws whatever qc::QuantumComputation::import throws for invalid input
+   */
+  std::unique_ptr<qc::QuantumComputation> import(const std::string& algo,
+                                                 qc::Format         format);
+  void                                    clear();
+  Stats                                   stats();
+
+private:
+  struct Key {
+    std::size_t hash = 0;
+    qc::Format  format{};
+
+    bool operator==(const Key& other) const {
+      return hash == other.hash && format == other.format;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return key.hash ^ (static_cast<std::size_t>(key.format) << 1U);
+    }
+  };
+  struct Entry {
+    Key key{};
+    // the text is compared on lookup, so hash collisions cannot mix circuits up
+    std::string                                   algo{};
+    std::shared_ptr<const qc::QuantumComputation> circuit{};
+  };
+  using EntryList = std::list<Entry>; // most recently used first
+  using Index     = std::unordered_map<Key, EntryList::iterator, KeyHash>;
+
+  CircuitCache() = default;
+
+  void insert(Entry entry);
+
+  std::mutex  mutex;
+  EntryList   entries{};
+  Index       index{};
+  std::size_t maxOperations    = DEFAULT_MAX_OPERATIONS;
+  std::size_t cachedOperations = 0;
+  std::size_t hits             = 0;
+  std::size_t misses           = 0;
+};
+
+/**
+ * @return the number of leading operations of after that equal the ones of
+ * before, i.e., the operations an edit from before to after left unchanged
+ */
+std::size_t unchangedOperations(const qc::QuantumComputation& before,
+                                const qc::QuantumComputation& after);
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef DOTCACHE_H
+#define DOTCACHE_H
+
+#include "GraphExport.h"
+#include "dd/Edge.hpp"
+#include "dd/Export.hpp"
+#include "dd/Package.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <list>
+#include <sstream>
+#include <string>
+
+/**Remembers the DOT representations of the most recently exported DDs, keyed
+ * by the root edge (node and weight) and the export options, so revisiting a
+ * state does not serialize it again. The cached edges are referenced, so their
+ * nodes are not collected and their addresses cannot be reused for different
+ * nodes while they are cached.
+ *
+ * The summed length of the cached strings is bounded; the least recently used
+ * entries are evicted first, except for the most recent one, which is always
+ * kept. The strings and the referenced nodes are reported by bytes and nodes,
+ * so they are part of the memory usage of the session.
+ */
+template <class Node> class DotCache {
+public:
+  static constexpr std::size_t DEFAULT_MAX_BYTES = 1U << 22U;
+
+  explicit DotCache(dd::Package<>& dd,
+                    std::size_t    maxBytes = DEFAULT_MAX_BYTES)
+      : dd(dd), maxBytes(maxBytes) {}
+  ~DotCache() { clear(); }
+
+  DotCache(const DotCache&)            = delete;
+  DotCache& operator=(const DotCache&) = delete;
+
+  /**Returns the DOT representation of the DD rooted at the given edge and
+   * exports it only if it is not cached yet. The reference stays valid until
+   * the next call.
+   */
+  const std::string& get(const dd::Edge<Node>&     e,
+                         const GraphExportOptions& options) {
+    const auto weight = static_cast<std::complex<dd::fp>>(e.w);
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->edge.p == e.p && it->weight == weight &&
+          it->options == options) {
+        entries.splice(entries.begin(), entries, it);
+        return entries.front().dot;
+      }
+    }
+
+    std::stringstream ss{};
+    dd::toDot(e, ss, options.colored, options.edgeLabels, options.classic,
+              false, options.polar);
+    dd.incRef(e);
+    entries.push_front({e, weight, options, ss.str(), e.size()});
+    cachedBytes += entries.front().dot.size();
+    cachedNodes += entries.front().nodes;
+    while (cachedBytes > maxBytes && entries.size() > 1)
+      evictLeastRecentlyUsed();
+    return entries.front().dot;
+  }
+
+  void clear() {
+    while (!entries.empty())
+      evictLeastRecentlyUsed();
+  }
+
+  // nodes are counted once per cached DD, even if the DDs share them
+  [[nodiscard]] std::size_t nodes() const { return cachedNodes; }
+  [[nodiscard]] std::size_t bytes() const { return cachedBytes; }
+
+private:
+  struct Entry {
+    dd::Edge<Node>       edge{};
+    std::complex<dd::fp> weight{};
+    GraphExportOptions   options{};
+    std::string          dot{};
+    std::size_t          nodes = 0;
+  };
+
+  void evictLeastRecentlyUsed() {
+    auto& entry = entries.back();
+    dd.decRef(entry.edge);
+    cachedBytes -= entry.dot.size();
+    cachedNodes -= entry.nodes;
+    entries.pop_back();
+  }
+
+  dd::Package<>&   dd;
+  std::size_t      maxBytes;
+  std::size_t      cachedBytes = 0;
+  std::size_t      cachedNodes = 0;
+  std::list<Entry> entries{}; // most recently used first
+};
+
+#endif
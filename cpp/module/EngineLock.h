@@ -0,0 +1,40 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef ENGINELOCK_H
+#define ENGINELOCK_H
+
+#include <mutex>
+#include <utility>
+
+/**Holds the lock of an engine for a complete operation. Before the lock is
+ * released, the engine measures its memory usage (see finishOperation of the
+ * engines), so the measurement happens on the thread that performed the
+ * operation, usually a worker thread, and the SessionRegistry can read the
+ * cached result without traversing any DD on the main thread.
+ */
+template <class Engine> class EngineLock {
+public:
+  EngineLock(Engine& engine, std::mutex& mutex)
+      : engine(&engine), lock(mutex) {}
+  ~EngineLock() {
+    if (engine != nullptr)
+      engine->finishOperation();
+  }
+
+  EngineLock(const EngineLock&)            = delete;
+  EngineLock& operator=(const EngineLock&) = delete;
+  EngineLock(EngineLock&& other) noexcept
+      : engine(std::exchange(other.engine, nullptr)),
+        lock(std::move(other.lock)) {}
+  EngineLock& operator=(EngineLock&&) = delete;
+
+private:
+  Engine*                      engine;
+  std::unique_lock<std::mutex> lock;
+};
+
+#endif
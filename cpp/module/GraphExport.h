@@ -0,0 +1,222 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef GRAPHEXPORT_H
+#define GRAPHEXPORT_H
+
+#include "dd/Edge.hpp"
+#include "dd/Package.hpp"
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**Mirrors the nodes of the exported DD between two exports, so that only the
+ * difference to the previous export has to be sent to the client.
+ *
+ * Every DD node gets an id that stays the same as long as the node is part of
+ * consecutive exports. Id 0 denotes the terminal. Nodes are identified by their
+ * address; since the package may reuse the memory of collected nodes, a node
+ * whose content differs from the one previously seen at the same address is
+ * reported as changed.
+ */
+template <class Node> class GraphModel {
+public:
+  static constexpr std::size_t RADIX = std::tuple_size_v<decltype(Node::e)>;
+
+  static constexpr std::uint64_t TERMINAL_ID = 0;
+
+  struct GraphEdge {
+    std::uint64_t        target = TERMINAL_ID;
+    std::complex<dd::fp> weight{};
+
+    bool operator==(const GraphEdge& other) const {
+      return target == other.target && weight == other.weight;
+    }
+    bool operator!=(const GraphEdge& other) const { return !(*this == other); }
+  };
+
+  struct GraphNode {
+    std::uint64_t                id    = TERMINAL_ID;
+    dd::Qubit                    qubit = 0;
+    std::array<GraphEdge, RADIX> edges{};
+  };
+
+  struct Diff {
+    bool      reset = false; // whether the diff is relative to an empty graph
+    GraphEdge root{};
+    // added nodes come after the nodes they point to
+    std::vector<GraphNode>     added{};
+    std::vector<GraphNode>     changed{}; // nodes whose content changed
+    std::vector<std::uint64_t> removed{};
+  };
+
+  /**Updates the model to the DD rooted at the given edge.
+   *
+   * @return the difference to the previously exported DD
+   */
+  Diff update(const dd::Edge<Node>& root) {
+    Diff diff{};
+    diff.reset = nodes.empty();
+
+    std::unordered_map<const Node*, GraphNode> next{};
+    next.reserve(nodes.size());
+    diff.root = visit(root, next, diff);
+
+    for (const auto& [node, graphNode] : nodes) {
+      if (next.count(node) == 0)
+        diff.removed.emplace_back(graphNode.id);
+    }
+    nodes = std::move(next);
+    return diff;
+  }
+
+  /**Forgets all nodes, so the next update reports the complete DD.
+   */
+  void clear() { nodes.clear(); }
+
+  [[nodiscard]] std::size_t size() const { return nodes.size(); }
+
+private:
+  GraphEdge visit(const dd::Edge<Node>&                        e,
+                  std::unordered_map<const Node*, GraphNode>& next,
+                  Diff&                                       diff) {
+    GraphEdge edge{TERMINAL_ID, static_cast<std::complex<dd::fp>>(e.w)};
+    if (e.isTerminal() || e.w.exactlyZero())
+      return edge;
+
+    if (const auto it = next.find(e.p); it != next.end()) {
+      edge.target = it->second.id;
+      return edge;
+    }
+
+    GraphNode graphNode{};
+    graphNode.qubit = e.p->v;
+    for (std::size_t i = 0; i < RADIX; ++i)
+      graphNode.edges[i] = visit(e.p->e[i], next, diff);
+
+    if (const auto it = nodes.find(e.p); it != nodes.end()) {
+      graphNode.id = it->second.id;
+      if (graphNode.qubit != it->second.qubit ||
+          graphNode.edges != it->second.edges)
+        diff.changed.emplace_back(graphNode);
+    } else {
+      graphNode.id = nextId++;
+      diff.added.emplace_back(graphNode);
+    }
+
+    next.emplace(e.p, graphNode);
+    edge.target = graphNode.id;
+    return edge;
+  }
+
+  std::unordered_map<const Node*, GraphNode> nodes{};
+  std::uint64_t                              nextId = TERMINAL_ID + 1;
+};
+
+/**Options of the structured export, with the same meaning as for dd::toDot.
+ */
+struct GraphExportOptions {
+  bool colored    = true;
+  bool edgeLabels = true;
+  bool classic    = false;
+  bool polar      = true;
+
+  bool operator==(const GraphExportOptions& other) const {
+    return colored == other.colored && edgeLabels == other.edgeLabels &&
+           classic == other.classic && polar == other.polar;
+  }
+};
+
+/**Structured representation of a DD as flat tables that can be handed over to
+ * JavaScript as typed arrays. Node ids are assigned in depth-first order and
+ * are only valid for a single export; see GraphModel for stable ids.
+ */
+struct GraphTables {
+  static constexpr std::uint32_t TERMINAL_ID = 0;
+  static constexpr std::uint32_t ROOT_ID =
+      std::numeric_limits<std::uint32_t>::max();
+
+  // nodes (the terminal is not listed)
+  std::vector<std::uint32_t> nodeIds{};
+  std::vector<std::int32_t>  nodeQubits{};
+  // edges, starting with the root edge whose source is ROOT_ID; zero edges are
+  // only listed for the classic style
+  std::vector<std::uint32_t> edgeSources{};
+  std::vector<std::uint32_t> edgeTargets{};
+  std::vector<std::uint8_t>  edgeIndices{}; // successor index at the source
+  // two entries per edge: (re, im) or, if polar, (magnitude, phase); empty if
+  // neither colors nor edge labels are shown
+  std::vector<double> edgeWeights{};
+  bool                polar = false;
+};
+
+namespace detail {
+template <class Node> class GraphTableBuilder {
+public:
+  GraphTableBuilder(GraphTables& tables, const GraphExportOptions& options)
+      : tables(tables), options(options),
+        weights(options.colored || options.edgeLabels) {
+    tables.polar = options.polar && weights;
+  }
+
+  void addEdge(const std::uint32_t source, const std::uint8_t index,
+               const dd::Edge<Node>& e) {
+    const auto zero = e.w.exactlyZero();
+    if (zero && !options.classic && source != GraphTables::ROOT_ID)
+      return;
+
+    const auto target = zero ? GraphTables::TERMINAL_ID : visit(e);
+    tables.edgeSources.emplace_back(source);
+    tables.edgeTargets.emplace_back(target);
+    tables.edgeIndices.emplace_back(index);
+    if (weights) {
+      const auto w = static_cast<std::complex<dd::fp>>(e.w);
+      tables.edgeWeights.emplace_back(tables.polar ? std::abs(w) : w.real());
+      tables.edgeWeights.emplace_back(tables.polar ? std::arg(w) : w.imag());
+    }
+  }
+
+private:
+  std::uint32_t visit(const dd::Edge<Node>& e) {
+    if (e.isTerminal())
+      return GraphTables::TERMINAL_ID;
+    if (const auto it = ids.find(e.p); it != ids.end())
+      return it->second;
+
+    const auto id = static_cast<std::uint32_t>(ids.size() + 1);
+    ids.emplace(e.p, id);
+    tables.nodeIds.emplace_back(id);
+    tables.nodeQubits.emplace_back(static_cast<std::int32_t>(e.p->v));
+    for (std::size_t i = 0; i < e.p->e.size(); ++i)
+      addEdge(id, static_cast<std::uint8_t>(i), e.p->e[i]);
+    return id;
+  }
+
+  GraphTables&                                   tables;
+  const GraphExportOptions&                      options;
+  bool                                           weights;
+  std::unordered_map<const Node*, std::uint32_t> ids{};
+};
+} // namespace detail
+
+/**Exports the DD rooted at the given edge as flat node and edge tables.
+ */
+template <class Node>
+GraphTables exportGraph(const dd::Edge<Node>&     root,
+                        const GraphExportOptions& options) {
+  GraphTables                     tables{};
+  detail::GraphTableBuilder<Node> builder(tables, options);
+  builder.addEdge(GraphTables::ROOT_ID, 0, root);
+  return tables;
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "OperationCache.h"
+
+#include <utility>
+
+/**Returns the DD of the given operation (or of its inverse) and builds and
+ * caches it if necessary. DDs that exceed the node budget on their own are
+ * returned without being cached.
+ *
+ * @param op the operation
+ * @param inverse whether the DD of the inverse operation is requested
+ */
+qc::MatrixDD OperationCache::get(const qc::Operation* op, const bool inverse) {
+  const Key key{op, inverse};
+  if (const auto it = entries.find(key); it != entries.end()) {
+    recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, it->second.use);
+    return it->second.matrix;
+  }
+
+  const auto matrix = inverse ? dd::getInverseDD(op, dd) : dd::getDD(op, dd);
+  const auto nodes  = matrix.size();
+  if (nodes > maxNodes)
+    return matrix;
+
+  dd.incRef(matrix);
+  recentlyUsed.push_front(key);
+  entries.emplace(key, Entry{matrix, nodes, recentlyUsed.begin()});
+  cachedNodes += nodes;
+  // the new entry is the most recently used one and fits the budget on its
+  // own, so it is never evicted here
+  while (cachedNodes > maxNodes)
+    evictLeastRecentlyUsed();
+  return matrix;
+}
+
+/**Hands the entries of the operations of a circuit over to the circuit that
+ * replaces it. The entries of the first `unchanged` operations of from are
+ * moved to the corresponding operations of to; the entries of the remaining
+ * operations of from are dropped. Entries of other circuits are not affected.
+ */
+void OperationCache::transfer(const qc::QuantumComputation& from,
+                              const qc::QuantumComputation& to,
+                              const std::size_t             unchanged) {
+  auto        toIt     = to.begin();
+  std::size_t position = 0;
+  for (const auto& op : from) {
+    for (const bool inverse : {false, true}) {
+      const auto it = entries.find({op.get(), inverse});
+      if (it == entries.end())
+        continue;
+      if (position >= unchanged) {
+        erase(it);
+        continue;
+      }
+      auto entry          = entries.extract(it);
+      entry.key()         = {toIt->get(), inverse};
+      *entry.mapped().use = entry.key();
+      entries.insert(std::move(entry));
+    }
+    if (position < unchanged)
+      ++toIt;
+    ++position;
+  }
+}
+
+void OperationCache::clear() {
+  for (auto& [key, entry] : entries)
+    dd.decRef(entry.matrix);
+  entries.clear();
+  recentlyUsed.clear();
+  cachedNodes = 0;
+}
+
+void OperationCache::evictLeastRecentlyUsed() {
+  erase(entries.find(recentlyUsed.back()));
+}
+
+void OperationCache::erase(const std::map<Key, Entry>::iterator it) {
+  dd.decRef(it->second.matrix);
+  cachedNodes -= it->second.nodes;
+  recentlyUsed.erase(it->second.use);
+  entries.erase(it);
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef OPERATIONCACHE_H
+#define OPERATIONCACHE_H
+
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility>
+
+/**Caches the (inverse) DDs of the operations of the loaded circuit(s), so
+ * stepping back and forth over the same operations does not rebuild them.
+ * Cached DDs are referenced, so they survive garbage collection. The summed
+ * node count of all entries is bounded; the least recently used entries are
+ * evicted first.
+ *
+ * Entries are keyed by the address of the operation, so whenever the
+ * operations of a circuit are replaced, their entries have to be transferred
+ * to the new operations or the cache has to be cleared.
+ */
+class OperationCache {
+public:
+  static constexpr std::size_t DEFAULT_MAX_NODES = 1U << 18U;
+
+  explicit OperationCache(dd::Package<>& dd,
+                          std::size_t    maxNodes = DEFAULT_MAX_NODES)
+      : dd(dd), maxNodes(maxNodes) {}
+  ~OperationCache() { clear(); }
+
+  OperationCache(const OperationCache&)            = delete;
+  OperationCache& operator=(const OperationCache&) = delete;
+
+  qc::MatrixDD get(const qc::Operation* op, bool inverse);
+  void         transfer(const qc::QuantumComputation& from,
+                        const qc::QuantumComputation& to,
+                        std::size_t                   unchanged);
+  void         clear();
+
+  [[nodiscard]] std::size_t size() const { return entries.size(); }
+  [[nodiscard]] std::size_t nodes() const { return cachedNodes; }
+
+private:
+  using Key = std::pair<const qc::Operation*, bool>;
+  struct Entry {
+    qc::MatrixDD             matrix{};
+    std::size_t              nodes = 0;
+    std::list<Key>::iterator use{};
+  };
+
+  void evictLeastRecentlyUsed();
+  void erase(std::map<Key, Entry>::iterator it);
+
+  dd::Package<>& dd;
+  std::size_t    maxNodes;
+  std::size_t    cachedNodes = 0;
+
+  std::map<Key, Entry> entries{};
+  std::list<Key>       recentlyUsed{}; // most recently used first
+};
+
+#endif
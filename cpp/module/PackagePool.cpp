@@ -0,0 +1,109 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "PackagePool.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+PackagePool& PackagePool::instance() {
+  static PackagePool pool{};
+  return pool;
+}
+
+PackagePool::PackagePtr PackagePool::acquire(const std::size_t nqubits,
+                                             const void*       requester) {
+  PackagePtr package{};
+  while (true) {
+    Reclaimer reclaim{};
+    {
+      std::lock_guard guard{mutex};
+      if (inUse < maxPackages) {
+        ++inUse;
+        if (!idle.empty()) {
+          package = std::move(idle.back());
+          idle.pop_back();
+          ++reused;
+        } else {
+          ++created;
+        }
+        break;
+      }
+      if (requester != nullptr)
+        reclaim = reclaimer;
+    }
+    // the reclaimer returns packages by calling release, so it runs outside
+    // the lock; another caller may take the freed package first, hence the loop
+    if (!reclaim || !reclaim(requester)) {
+      std::stringstream msg;
+      msg << "The server is currently handling the maximum of " << maxPackages
+          << " sessions. Please try again later!";
+      throw std::runtime_error(msg.str());
+    }
+  }
+
+  // the tables are set up outside the lock, since this may take a while
+  try {
+    if (package)
+      package->resize(nqubits);
+    else
+      package = std::make_unique<dd::Package<>>(nqubits);
+  } catch (...) {
+    std::lock_guard guard{mutex};
+    --inUse;
+    throw;
+  }
+  return package;
+}
+
+/**Takes back a package that is no longer used. All of its nodes are dropped,
+ * so DDs that still point into the package must not be used afterwards.
+ */
+void PackagePool::release(PackagePtr package) {
+  if (!package)
+    return;
+  package->reset();
+
+  std::lock_guard guard{mutex};
+  --inUse;
+  if (idle.size() < maxIdle && inUse + idle.size() < maxPackages)
+    idle.emplace_back(std::move(package));
+  // otherwise the package is destroyed when it goes out of scope
+}
+
+/**Changes the limits of the pool. Packages in use are not affected, but kept
+ * packages beyond the new limit are destroyed.
+ */
+void PackagePool::setLimits(const std::size_t maxPackages,
+                            const std::size_t maxIdle) {
+  std::vector<PackagePtr> dropped{};
+  {
+    std::lock_guard guard{mutex};
+    this->maxPackages = maxPackages;
+    this->maxIdle     = maxIdle;
+    while (!idle.empty() &&
+           (idle.size() > maxIdle || inUse + idle.size() > maxPackages)) {
+      // the least recently released packages are dropped first
+      dropped.emplace_back(std::move(idle.front()));
+      idle.erase(idle.begin());
+    }
+  }
+  // dropped packages are destroyed outside the lock
+}
+
+/**Sets the function acquire calls when all packages are in use. It is called
+ * without holding the lock of the pool and must not acquire packages itself.
+ */
+void PackagePool::setReclaimer(Reclaimer reclaimer) {
+  std::lock_guard guard{mutex};
+  this->reclaimer = std::move(reclaimer);
+}
+
+PackagePool::Occupancy PackagePool::occupancy() {
+  std::lock_guard guard{mutex};
+  return {inUse, idle.size(), maxPackages, maxIdle, created, reused};
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef PACKAGEPOOL_H
+#define PACKAGEPOOL_H
+
+#include "dd/Package.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**Number of nodes a session keeps alive in its DD package and the memory they
+ * occupy.
+ */
+struct MemoryUsage {
+  std::size_t nodes = 0;
+  std::size_t bytes = 0;
+};
+
+/**Process-wide pool of DD packages shared by all sessions. A session only
+ * acquires a package once it loads a circuit and hands it back when it is
+ * destroyed. Returned packages are reset and kept for the next session, so
+ * their tables do not have to be allocated again.
+ *
+ * The number of packages in use is capped, since the memory of the server is
+ * dominated by the tables of the packages. Once the cap is reached, acquire
+ * asks the reclaimer (installed by the SessionRegistry) to free the packages of
+ * idle sessions and only fails if none can be freed, instead of exhausting the
+ * memory.
+ */
+class PackagePool {
+public:
+  static constexpr std::size_t DEFAULT_MAX_PACKAGES = 64;
+  static constexpr std::size_t DEFAULT_MAX_IDLE     = 8;
+
+  struct Occupancy {
+    std::size_t inUse       = 0;
+    std::size_t idle        = 0;
+    std::size_t maxPackages = 0; // maximum number of packages in use
+    std::size_t maxIdle     = 0; // maximum number of kept packages
+    std::size_t created     = 0; // packages constructed since the start
+    std::size_t reused      = 0; // acquisitions served by a kept package
+  };
+
+  using PackagePtr = std::unique_ptr<dd::Package<>>;
+  // returns at least one package to the pool, sparing the session of the
+  // requester, and reports whether it could
+  using Reclaimer = std::function<bool(const void* requester)>;
+
+  static PackagePool& instance();
+
+  PackagePool(const PackagePool&)            = delete;
+  PackagePool& operator=(const PackagePool&) = delete;
+
+  /**Returns a package for the given number of qubits, reusing a kept one if
+   * possible. If all packages are in use, the reclaimer may evict other
+   * sessions, but only if the requester (the engine whose lock the caller
+   * holds) is given, so packages that are merely nice to have never cost
+   * another session its state.
+   *
+   * @throws std::runtime_error if the maximum number of packages is in use and
+   * none can be reclaimed
+   */
+  PackagePtr acquire(std::size_t nqubits, const void* requester = nullptr);
+  void       release(PackagePtr package);
+
+  void      setLimits(std::size_t maxPackages, std::size_t maxIdle);
+  void      setReclaimer(Reclaimer reclaimer);
+  Occupancy occupancy();
+
+private:
+  PackagePool() = default;
+
+  std::mutex              mutex;
+  std::vector<PackagePtr> idle{}; // most recently released last
+  Reclaimer               reclaimer{};
+  std::size_t             inUse       = 0;
+  std::size_t             maxPackages = DEFAULT_MAX_PACKAGES;
+  std::size_t             maxIdle     = DEFAULT_MAX_IDLE;
+  std::size_t             created     = 0;
+  std::size_t             reused      = 0;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+/**Inserts the sample into the list ordered by before if it is among the first
+ * TOP_SAMPLES.
+ */
+template <class Before>
+void insertTop(std::vector<Profiler::Sample>& top,
+               const Profiler::Sample&        sample, Before before) {
+  const auto it = std::upper_bound(top.begin(), top.end(), sample, before);
+  if (static_cast<std::size_t>(it - top.begin()) >= Profiler::TOP_SAMPLES)
+    return;
+  top.insert(it, sample);
+  if (top.size() > Profiler::TOP_SAMPLES)
+    top.pop_back();
+}
+
+double microseconds(const std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+double hitRatio(const std::size_t hits, const std::size_t lookups) {
+  return lookups == 0 ? 0. : static_cast<double>(hits) /
+                                 static_cast<double>(lookups);
+}
+
+void writeSample(std::ostream& os, const Profiler::Sample& sample) {
+  os << R"({"algo1":)" << (sample.algo1 ? "true" : "false")
+     << R"(,"inverse":)" << (sample.inverse ? "true" : "false")
+     << R"(,"position":)" << sample.position << R"(,"operations":)"
+     << sample.operations << R"(,"gate":")" << qc::toString(sample.type)
+     << R"(","getDD":)" << microseconds(sample.getDD) << R"(,"multiply":)"
+     << microseconds(sample.multiply) << R"(,"garbageCollect":)"
+     << microseconds(sample.garbageCollect) << R"(,"nodes":)" << sample.nodes
+     << R"(,"hitRatio":)" << hitRatio(sample.hits, sample.lookups) << "}";
+}
+
+void writeSamples(std::ostream&                        os,
+                  const std::vector<Profiler::Sample>& list) {
+  os << "[";
+  for (std::size_t i = 0; i < list.size(); ++i) {
+    if (i > 0)
+      os << ",";
+    writeSample(os, list[i]);
+  }
+  os << "]";
+}
+} // namespace
+
+/**Enables or disables recording. Enabling starts from scratch, so the
+ * statistics only cover steps taken while the profiler was enabled.
+ */
+void Profiler::setEnabled(const bool enable) {
+  if (enable && !enabled)
+    clear();
+  enabled = enable;
+}
+
+void Profiler::clear() {
+  steps          = 0;
+  lookups        = 0;
+  hits           = 0;
+  getDD          = {};
+  multiply       = {};
+  garbageCollect = {};
+  histogram.fill(0);
+  slowest.clear();
+  largest.clear();
+}
+
+void Profiler::record(const Sample& sample) {
+  ++steps;
+  lookups += sample.lookups;
+  hits += sample.hits;
+  getDD += sample.getDD;
+  multiply += sample.multiply;
+  garbageCollect += sample.garbageCollect;
+
+  auto        time   = static_cast<std::uint64_t>(microseconds(sample.total()));
+  std::size_t bucket = 0;
+  while (time > 1 && bucket + 1 < HISTOGRAM_BUCKETS) {
+    time >>= 1U;
+    ++bucket;
+  }
+  ++histogram[bucket];
+
+  insertTop(slowest, sample, [](const Sample& lhs, const Sample& rhs) {
+    return lhs.total() > rhs.total();
+  });
+  insertTop(largest, sample, [](const Sample& lhs, const Sample& rhs) {
+    return lhs.nodes > rhs.nodes;
+  });
+}
+
+/**Writes the statistics as compact JSON. All durations are given in
+ * microseconds.
+ *
+ * @return an object with enabled, the number of recorded steps, the hit ratio
+ * of the multiplication compute table, the total durations of the phases
+ * (time), the histogram of the step times (see HISTOGRAM_BUCKETS) as well as
+ * the slowest steps and the steps with the largest resulting DDs (slowest,
+ * largest)
+ */
+std::string Profiler::toJson() const {
+  std::ostringstream os{};
+  os << R"({"enabled":)" << (enabled ? "true" : "false") << R"(,"steps":)"
+     << steps << R"(,"hitRatio":)" << hitRatio(hits, lookups)
+     << R"(,"time":{"getDD":)" << microseconds(getDD) << R"(,"multiply":)"
+     << microseconds(multiply) << R"(,"garbageCollect":)"
+     << microseconds(garbageCollect) << R"(},"histogram":[)";
+  for (std::size_t i = 0; i < histogram.size(); ++i)
+    os << (i > 0 ? "," : "") << histogram[i];
+  os << R"(],"slowest":)";
+  writeSamples(os, slowest);
+  os << R"(,"largest":)";
+  writeSamples(os, largest);
+  os << "}";
+  return os.str();
+}
@@ -0,0 +1,155 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "ir/operations/OpType.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**Records how long the single phases of applying an operation take (building
+ * its DD, the multiplication and the garbage collection), how large the DD
+ * gets and how often the multiplication is answered by the compute table.
+ *
+ * Only aggregates are kept: the totals, a histogram of the step times and the
+ * slowest steps as well as the steps leading to the largest DDs, so that hot
+ * operations and blow-ups can be located in long sessions without the memory
+ * growing with every step. Recording is disabled by default, since counting
+ * the nodes of the resulting DD traverses it.
+ */
+class Profiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // number of slowest steps and of steps with the largest DDs that are kept
+  static constexpr std::size_t TOP_SAMPLES = 16;
+  // bucket i counts the steps that took [2^i, 2^(i+1)) microseconds (the first
+  // bucket includes faster steps, the last bucket slower ones)
+  static constexpr std::size_t HISTOGRAM_BUCKETS = 24;
+
+  struct Sample {
+    bool         algo1    = true;  // only meaningful for verification
+    bool         inverse  = false; // whether the step went backwards
+    unsigned int position = 0;     // position of the first applied operation
+    // more than one if a whole segment was applied at once
+    unsigned int operations = 1;
+    qc::OpType   type       = qc::OpType::None; // of the first operation
+
+    // durations of the phases of the step
+    std::chrono::nanoseconds getDD{};
+    std::chrono::nanoseconds multiply{};
+    std::chrono::nanoseconds garbageCollect{};
+    // size of the resulting DD and accesses of the multiplication compute table
+    std::size_t nodes   = 0;
+    std::size_t lookups = 0;
+    std::size_t hits    = 0;
+
+    [[nodiscard]] std::chrono::nanoseconds total() const {
+      return getDD + multiply + garbageCollect;
+    }
+  };
+
+  /**Measures a single step. The phases are closed by lap in the order they
+   * happen and finish hands the sample to the profiler. If the profiler is
+   * disabled, all methods return immediately.
+   */
+  class Measurement {
+  public:
+    void lap(std::chrono::nanoseconds Sample::*phase) {
+      if (profiler == nullptr)
+        return;
+      const auto now = Clock::now();
+      sample.*phase += now - last;
+      last = now;
+    }
+
+    /**Records the sample. The statistics of the compute table are those of
+     * the table passed to Profiler::measure.
+     */
+    template <class Table, class Edge>
+    void finish(const Table& table, const Edge& result) {
+      if (profiler == nullptr)
+        return;
+      const auto& stats = table.getStats();
+      sample.lookups    = stats.lookups - sample.lookups;
+      sample.hits       = stats.hits - sample.hits;
+      sample.nodes      = result.size();
+      profiler->record(sample);
+    }
+
+    /**Attributes the sample to another operation, for steps that only know
+     * which operation they apply after the measurement has started.
+     */
+    void attribute(const bool algo1, const unsigned int position,
+                   const qc::OpType type) {
+      sample.algo1    = algo1;
+      sample.position = position;
+      sample.type     = type;
+    }
+
+  private:
+    friend class Profiler;
+
+    Profiler*         profiler = nullptr;
+    Sample            sample{};
+    Clock::time_point last{};
+  };
+
+  /**Starts measuring a step that applies the operations from position on
+   * (backwards if inverse is set). The statistics of the given compute table
+   * are reported for the step.
+   */
+  template <class Table>
+  [[nodiscard]] Measurement
+  measure(const Table&       table, const unsigned int position,
+          const unsigned int operations, const qc::OpType type,
+          const bool         inverse, const bool algo1 = true) {
+    Measurement measurement{};
+    if (!enabled)
+      return measurement;
+    auto& sample      = measurement.sample;
+    sample.algo1      = algo1;
+    sample.inverse    = inverse;
+    sample.position   = position;
+    sample.operations = operations;
+    sample.type       = type;
+    // the counters of the table are stored until finish computes the deltas
+    const auto& stats    = table.getStats();
+    sample.lookups       = stats.lookups;
+    sample.hits          = stats.hits;
+    measurement.profiler = this;
+    measurement.last     = Clock::now();
+    return measurement;
+  }
+
+  void               setEnabled(bool enable);
+  [[nodiscard]] bool isEnabled() const { return enabled; }
+  void               clear();
+
+  [[nodiscard]] std::string toJson() const;
+
+private:
+  void record(const Sample& sample);
+
+  bool                                       enabled = false;
+  std::size_t                                steps   = 0;
+  std::size_t                                lookups = 0;
+  std::size_t                                hits    = 0;
+  std::chrono::nanoseconds                   getDD{};
+  std::chrono::nanoseconds                   multiply{};
+  std::chrono::nanoseconds                   garbageCollect{};
+  std::array<std::size_t, HISTOGRAM_BUCKETS> histogram{};
+  std::vector<Sample>                        slowest{}; // slowest first
+  std::vector<Sample>                        largest{}; // largest DD first
+};
+
+#endif
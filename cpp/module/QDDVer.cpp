@@ -6,7 +6,342 @@
 
 #include "QDDVer.h"
 
-#include "dd/Export.hpp"
+#include "AsyncTask.h"
+#include "SessionFile.h"
+#include "SessionRegistry.h"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+
+namespace {
+struct LoadArguments {
+  std::string  algo{};
+  unsigned int formatCode = 0;
+  unsigned int opNum      = 0;
+  bool         process    = false;
+  bool         algo1      = false;
+};
+
+struct LineArguments {
+  unsigned int targetPos = 0;
+  bool         algo1     = false;
+};
+
+/**Checks and extracts the arguments of load/loadAsync. Throws a JavaScript
+ * exception and returns nothing if they are invalid.
+ *
+ * @param withAlgorithm false for endLoadAsync, whose arguments start with the
+ * format code since the algorithm has been streamed before
+ */
+std::optional<LoadArguments>
+parseLoadArguments(const Napi::CallbackInfo& info,
+                   const bool                withAlgorithm = true) {
+  Napi::Env  env   = info.Env();
+  const auto first = withAlgorithm ? 1U : 0U; // index of the format code
+  // check if the correct parameters have been passed
+  if (info.Length() < first + 4) {
+    Napi::RangeError::New(
+        env, withAlgorithm
+                 ? "Need 5 (String, unsigned int, unsigned int, bool, bool) "
+                   "arguments!"
+                 : "Need 4 (unsigned int, unsigned int, bool, bool) "
+                   "arguments!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (withAlgorithm && !info[0].IsString()) { // algorithm
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first].IsNumber()) { // format code (1 = QASM, 2 = Real)
+    Napi::TypeError::New(env, "arg3: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first + 1].IsNumber()) { // number of operations to immediately
+                                     // process
+    Napi::TypeError::New(env, "arg2: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first + 2].IsBoolean()) { // whether operations should be processed
+                                      // while advancing the iterator to opNum
+                                      // or not (true = new simulation; false =
+                                      // continue simulation)
+    Napi::TypeError::New(env, "arg3: boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first + 3].IsBoolean()) { // whether we load as algo1 (true) or
+                                      // algo2 (false)
+    Napi::TypeError::New(env, "arg4: boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+
+  LoadArguments args{};
+  if (withAlgorithm)
+    args.algo = info[0].As<Napi::String>().Utf8Value();
+  args.formatCode = static_cast<unsigned int>(info[first].As<Napi::Number>());
+  // at this point opNum might be bigger than the number of operations the
+  // algorithm has!
+  args.opNum   = static_cast<unsigned int>(info[first + 1].As<Napi::Number>());
+  args.process = static_cast<bool>(info[first + 2].As<Napi::Boolean>());
+  args.algo1   = static_cast<bool>(info[first + 3].As<Napi::Boolean>());
+  return args;
+}
+
+/**Appends a chunk of a streamed algorithm (Buffer or String) to the given
+ * text. Throws a JavaScript exception and returns false if the chunk is invalid
+ * or the text would get too long.
+ */
+bool appendChunk(const Napi::CallbackInfo& info, std::string& text,
+                 const std::size_t maxSize) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !(info[0].IsBuffer() || info[0].IsString())) {
+    Napi::TypeError::New(env, "arg1: Buffer or String expected!")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (info[0].IsBuffer()) {
+    const auto chunk = info[0].As<Napi::Buffer<char>>();
+    if (text.size() + chunk.Length() > maxSize) {
+      Napi::RangeError::New(env, "The algorithm is too large!")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    text.append(chunk.Data(), chunk.Length());
+  } else {
+    const auto chunk = info[0].As<Napi::String>().Utf8Value();
+    if (text.size() + chunk.size() > maxSize) {
+      Napi::RangeError::New(env, "The algorithm is too large!")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    text.append(chunk);
+  }
+  return true;
+}
+
+/**Checks and extracts the arguments of toLine/toLineAsync. Throws a JavaScript
+ * exception and returns nothing if they are invalid.
+ */
+std::optional<LineArguments>
+parseLineArguments(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() < 2) {
+    Napi::RangeError::New(env, "Need 2 (unsigned int, bool) arguments!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[0].IsNumber()) { // line number/position
+    Napi::TypeError::New(env, "arg1: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[1].IsBoolean()) { // algo1
+    Napi::TypeError::New(env, "arg2: Boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+
+  LineArguments args{};
+  args.targetPos = static_cast<unsigned int>(info[0].As<Napi::Number>());
+  args.algo1     = static_cast<bool>(info[1].As<Napi::Boolean>());
+  return args;
+}
+
+/**Checks and extracts the algo1 argument most methods take.
+ */
+std::optional<bool> parseAlgoArgument(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[0].IsBoolean()) { // algo1
+    Napi::TypeError::New(env, "arg1: Boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  return static_cast<bool>(info[0].As<Napi::Boolean>());
+}
+
+Napi::Object loadState(Napi::Env env, const std::size_t numOfOperations) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("numOfOperations",
+            Napi::Number::New(env, static_cast<double>(numOfOperations)));
+  return state;
+}
+
+Napi::Object stepState(Napi::Env                                 env,
+                       const VerificationEngine::StepResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  return state;
+}
+
+Napi::Object toEndState(Napi::Env                                  env,
+                        const VerificationEngine::ToEndResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  state.Set("barrier", Napi::Boolean::New(env, result.barrier));
+  state.Set("nops", Napi::Number::New(env, static_cast<double>(result.nops)));
+  return state;
+}
+
+Napi::Object ddState(Napi::Env env, const std::string& dot) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("dot", Napi::String::New(env, dot));
+  state.Set("amplitudes", Napi::Float32Array::New(env, 0));
+  return state;
+}
+
+std::optional<std::string> parsePathArgument(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) { // path of the session file
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  return info[0].As<Napi::String>().Utf8Value();
+}
+
+Napi::Object
+restoredAlgorithmState(Napi::Env                                    env,
+                       const VerificationEngine::RestoredAlgorithm& algorithm) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("ready", Napi::Boolean::New(env, algorithm.ready));
+  if (!algorithm.ready)
+    return state;
+  state.Set("algo", Napi::String::New(env, algorithm.algo));
+  state.Set("format", Napi::Number::New(env, algorithm.formatCode));
+  state.Set("position", Napi::Number::New(env, algorithm.position));
+  state.Set("numOfOperations",
+            Napi::Number::New(env,
+                              static_cast<double>(algorithm.numOfOperations)));
+  return state;
+}
+
+Napi::Object restoreState(Napi::Env                                env,
+                          const VerificationEngine::RestoreResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("algo1", restoredAlgorithmState(env, result.algo1));
+  state.Set("algo2", restoredAlgorithmState(env, result.algo2));
+  return state;
+}
+
+/**Extracts the strategy of checkEquivalence ("onetoone", "proportional",
+ * "lookahead" or "parallel"). Throws a JavaScript exception and returns nothing
+ * if it is invalid.
+ */
+std::optional<VerificationEngine::Strategy>
+parseStrategyArgument(const Napi::CallbackInfo& info) {
+  using Strategy = VerificationEngine::Strategy;
+
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) { // strategy
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  const auto name = info[0].As<Napi::String>().Utf8Value();
+  if (name == "onetoone")
+    return Strategy::OneToOne;
+  if (name == "proportional")
+    return Strategy::Proportional;
+  if (name == "lookahead")
+    return Strategy::Lookahead;
+  if (name == "parallel")
+    return Strategy::Parallel;
+  Napi::RangeError::New(env, "arg1: \"onetoone\", \"proportional\", "
+                             "\"lookahead\" or \"parallel\" expected!")
+      .ThrowAsJavaScriptException();
+  return std::nullopt;
+}
+
+Napi::Object
+equivalenceState(Napi::Env                                    env,
+                 const VerificationEngine::EquivalenceResult& result) {
+  using Equivalence = VerificationEngine::Equivalence;
+
+  Napi::Object state = Napi::Object::New(env);
+  switch (result.equivalence) {
+  case Equivalence::Equivalent:
+    state.Set("equivalence", Napi::String::New(env, "equivalent"));
+    break;
+  case Equivalence::EquivalentUpToGlobalPhase:
+    state.Set("equivalence",
+              Napi::String::New(env, "equivalent_up_to_global_phase"));
+    break;
+  case Equivalence::NotEquivalent:
+    state.Set("equivalence", Napi::String::New(env, "not_equivalent"));
+    break;
+  }
+  state.Set("complete", Napi::Boolean::New(env, result.complete));
+  if (result.counterexample.has_value())
+    state.Set("counterexample",
+              Napi::String::New(env, *result.counterexample));
+  return state;
+}
+
+Napi::Object
+simulationCheckState(Napi::Env                                        env,
+                     const VerificationEngine::SimulationCheckResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("passed", Napi::Boolean::New(env, result.passed));
+  state.Set("stimuli",
+            Napi::Number::New(env, static_cast<double>(result.stimuli)));
+  state.Set("fidelity", Napi::Number::New(env, result.fidelity));
+  if (result.counterexample.has_value())
+    state.Set("counterexample",
+              Napi::String::New(env, *result.counterexample));
+  return state;
+}
+
+Napi::Object checkState(Napi::Env                              env,
+                        const VerificationEngine::CheckResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("nops1", Napi::Number::New(env, static_cast<double>(result.nops1)));
+  state.Set("nops2", Napi::Number::New(env, static_cast<double>(result.nops2)));
+  state.Set("equivalence", equivalenceState(env, result.equivalence));
+  return state;
+}
+
+Napi::Object prevState(Napi::Env                             env,
+                       const VerificationEngine::StepResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  return state;
+}
+
+/**Locks the engine for a synchronous method. The main thread must not wait for
+ * an operation running on a worker thread, so if the engine is busy, an error
+ * with code "EBUSY" is thrown as JavaScript exception and the returned lock
+ * does not own the mutex.
+ */
+std::unique_lock<std::mutex> tryLockEngine(Napi::Env           env,
+                                           VerificationEngine& engine) {
+  auto lock = engine.tryLock();
+  if (!lock.owns_lock()) {
+    auto error = Napi::Error::New(env, "The session is busy, try again later!");
+    error.Value().Set("code", Napi::String::New(env, "EBUSY"));
+    error.ThrowAsJavaScriptException();
+  }
+  return lock;
+}
+} // namespace
 
 Napi::Object QDDVer::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
@@ -23,7 +358,26 @@ Napi::Object QDDVer::Init(Napi::Env env, Napi::Object exports) {
        InstanceMethod("updateExportOptions", &QDDVer::UpdateExportOptions),
        InstanceMethod("getExportOptions", &QDDVer::GetExportOptions),
        InstanceMethod("isReady", &QDDVer::IsReady),
-       InstanceMethod("unready", &QDDVer::Unready)});
+       InstanceMethod("unready", &QDDVer::Unready),
+       InstanceMethod("setSegmentMatrices", &QDDVer::SetSegmentMatrices),
+       InstanceMethod("setProfiling", &QDDVer::SetProfiling),
+       InstanceMethod("getStats", &QDDVer::GetStats),
+       InstanceMethod("beginLoad", &QDDVer::BeginLoad),
+       InstanceMethod("pushChunk", &QDDVer::PushChunk),
+       InstanceMethod("loadAsync", &QDDVer::LoadAsync),
+       InstanceMethod("endLoadAsync", &QDDVer::EndLoadAsync),
+       InstanceMethod("toStartAsync", &QDDVer::ToStartAsync),
+       InstanceMethod("prevAsync", &QDDVer::PrevAsync),
+       InstanceMethod("nextAsync", &QDDVer::NextAsync),
+       InstanceMethod("toEndAsync", &QDDVer::ToEndAsync),
+       InstanceMethod("prepareSegmentsAsync", &QDDVer::PrepareSegmentsAsync),
+       InstanceMethod("toLineAsync", &QDDVer::ToLineAsync),
+       InstanceMethod("checkEquivalenceAsync", &QDDVer::CheckEquivalenceAsync),
+       InstanceMethod("getEquivalenceAsync", &QDDVer::GetEquivalenceAsync),
+       InstanceMethod("simulationCheckAsync", &QDDVer::SimulationCheckAsync),
+       InstanceMethod("getDDAsync", &QDDVer::GetDDAsync),
+       InstanceMethod("saveStateAsync", &QDDVer::SaveStateAsync),
+       InstanceMethod("restoreStateAsync", &QDDVer::RestoreStateAsync)});
 
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
@@ -33,155 +387,22 @@ Napi::Object QDDVer::Init(Napi::Env env, Napi::Object exports) {
 }
 
 // constructor
-/**Parameterless default constructor, just initializes variables
+/**Constructor, just initializes variables
  *
- * @param info takes no parameters
+ * @param info optionally the key of the session the object belongs to (string);
+ * with a key, the engine is managed by the SessionRegistry and shared with the
+ * other objects of the session
  */
 QDDVer::QDDVer(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<QDDVer>(info) {
   Napi::Env         env = info.Env();
   Napi::HandleScope scope(env);
 
-  this->dd = std::make_unique<dd::Package<>>(1);
-
-  this->qc1       = std::make_unique<qc::QuantumComputation>();
-  this->iterator1 = this->qc1->begin();
-  this->position1 = 0;
-
-  this->qc2       = std::make_unique<qc::QuantumComputation>();
-  this->iterator2 = this->qc2->begin();
-  this->position2 = 0;
-}
-
-/**Applies the current operation/DD (determined by iterator) and increments both
- * iterator and position. If iterator reaches its end, atEnd will be set to
- * true.
- *
- * @param algo1 decides whether the function should be applied to algo1 or
- * algo2.
- */
-void QDDVer::stepForward(bool algo1) {
-  if (algo1) {
-    if (atEnd1)
-      return; // no further steps possible
-    const auto currDD = dd::getDD(iterator1->get(),
-                                  *dd); // retrieve the "new" current operation
-
-    auto temp = dd->multiply(
-        currDD, sim); // process the current operation by multiplying it with
-                      // the previous simulation-state
-    dd->incRef(temp);
-    dd->decRef(sim);
-    sim = temp;
-    dd->garbageCollect();
-
-    iterator1++; // advance iterator
-    position1++;
-    // qc1->end() is after the last operation in the iterator
-    if (iterator1 == qc1->end())
-      atEnd1 = true;
-
-  } else {
-    if (atEnd2)
-      return; // no further steps possible
-    const auto currDD = dd::getInverseDD(
-        iterator2->get(),
-        *dd); // retrieve the inverse of the "new" current operation
-
-    auto temp = dd->multiply(
-        sim, currDD); // process the current operation by multiplying it with
-                      // the previous simulation-state
-    dd->incRef(temp);
-    dd->decRef(sim);
-    sim = temp;
-    dd->garbageCollect();
-
-    iterator2++; // advance iterator
-    position2++;
-    // qc2->end() is after the last operation in the iterator
-    if (iterator2 == qc2->end())
-      atEnd2 = true;
-  }
-}
-
-/**If either atInitial is true or the iterator is at the beginning, this method
- * does nothing. In other cases it will first decrement both position and
- * iterator before applying the inverse of the operation/DD the iterator is then
- * pointing at.
- *
- * @param algo1 decides whether the function should be applied to algo1 or
- * algo2.
- *
- */
-void QDDVer::stepBack(bool algo1) {
-  if (algo1) {
-    if (atInitial1)
-      return; // no step back possible
-
-    if (iterator1 == qc1->begin()) {
-      atInitial1 = true;
-      return;
-    }
-
-    iterator1--; // set iterator back to the desired operation
-    position1--;
-
-    const auto currDD = dd::getInverseDD(
-        iterator1->get(), *dd); // get the inverse of the current operation
-
-    auto temp = dd->multiply(
-        currDD,
-        sim); //"remove" the current operation by multiplying with its inverse
-    dd->incRef(temp);
-    dd->decRef(sim);
-    sim = temp;
-    dd->garbageCollect();
-
-  } else {
-    if (atInitial2)
-      return; // no step back possible
-
-    if (iterator2 == qc2->begin()) {
-      atInitial2 = true;
-      return;
-    }
-
-    iterator2--; // set iterator back to the desired operation
-    position2--;
-
-    const auto currDD =
-        dd::getDD(iterator2->get(), *dd); // get the current operation
-
-    auto temp = dd->multiply(sim, currDD); //"remove" the current operation by
-                                           // multiplying with its inverse
-    dd->incRef(temp);
-    dd->decRef(sim);
-    sim = temp;
-    dd->garbageCollect();
-  }
-}
-
-/**Removes all applied operations by taking steps back until atInitial is true.
- * atInitial will be true and in most cases atEnd will be false (special case
- * for empty algorithms: atEnd is also true) after this call.
- *
- * @param algo1 decides whether the function should be applied to algo1 or
- * algo2.
- */
-void QDDVer::stepToStart(bool algo1) {
-  if (algo1) {
-    // go one step back at a time until all operations have been reversed
-    // (atInitial is set to true in stepBack)
-    while (!atInitial1)
-      stepBack(true);
-    // now atInitial is true, exactly as it should be
-  } else {
-    // go one step back at a time until all operations have been reversed
-    // (atInitial is set to true in stepBack)
-    while (!atInitial2)
-      stepBack(false);
-    // now atInitial is true, exactly as it should be
-  }
+  if (info.Length() > 0 && info[0].IsString())
+    this->engine = SessionRegistry::instance().verification(
+        info[0].As<Napi::String>().Utf8Value());
+  else
+    this->engine = std::make_shared<VerificationEngine>();
 }
 
 /**Parameters: String algorithm, unsigned int formatCode, unsigned int num of
@@ -198,197 +419,106 @@ Napi::Value QDDVer::Load(const Napi::CallbackInfo& info) {
   Napi::Object state = Napi::Object::New(env);
   state.Set("numOfOperations", Napi::Number::New(env, -1));
 
-  // check if the correct parameters have been passed
-  if (info.Length() < 5) {
-    Napi::RangeError::New(
-        env,
-        "Need 5 (String, unsigned int, unsigned int, bool, bool) arguments!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsString()) { // algorithm
-    Napi::TypeError::New(env, "arg1: String expected!")
-        .ThrowAsJavaScriptException();
+  auto args = parseLoadArguments(info);
+  if (!args.has_value())
     return state;
-  }
-  if (!info[1].IsNumber()) { // format code (1 = QASM, 2 = Real)
-    Napi::TypeError::New(env, "arg3: unsigned int expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[2].IsNumber()) { // number of operations to immediately process
-    Napi::TypeError::New(env, "arg2: unsigned int expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[3].IsBoolean()) { // whether operations should be processed while
-                              // advancing the iterator to opNum or not (true =
-                              // new simulation; false = continue simulation)
-    Napi::TypeError::New(env, "arg3: boolean expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[4].IsBoolean()) { // whether we load as algo1 (true) or algo2
-                              // (false)
-    Napi::TypeError::New(env, "arg4: boolean expected!")
-        .ThrowAsJavaScriptException();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
     return state;
-  }
-
-  // the first parameter (algorithm)
-  auto              arg  = info[0].As<Napi::String>();
-  const std::string algo = arg.Utf8Value();
-  std::stringstream ss{algo};
-
-  // the third parameter (how many operations to apply immediately)
-  auto opNum = static_cast<unsigned int>(info[2].As<Napi::Number>());
-  // at this point opNum might be bigger than the number of operations the
-  // algorithm has!
-
-  // the fourth parameter tells us to process iterated operations or not
-  const bool process = static_cast<bool>(info[3].As<Napi::Boolean>());
-
-  // the fifth parameter (algo1)
-  const auto algo1 = static_cast<bool>(info[4].As<Napi::Boolean>());
 
   try {
-    // second parameter describes the format of the algorithm
-    const auto formatCode =
-        static_cast<unsigned int>(info[1].As<Napi::Number>());
-    qc::Format format;
-    if (formatCode == 1)
-      format = qc::Format::OpenQASM3;
-    else if (formatCode == 2)
-      format = qc::Format::Real;
-    else {
-      Napi::Error::New(env, "Invalid format-code!")
-          .ThrowAsJavaScriptException();
-      return state;
-    }
-
-    if (algo1) {
-      qc1->import(ss, format);
-      // check if the number of qubits is the same for both algorithms
-      if (ready2 && qc1->getNqubits() != qc2->getNqubits()) {
-        // algo2 is already loaded (because ready2 is true), so we reset algo1
-        qc1->reset();
-        ready1 = false;
-        std::stringstream msg;
-        msg << "Number of qubits don't match! This algorithm needs "
-            << qc2->getNqubits() << " qubits.";
-        Napi::Error::New(env, msg.str()).ThrowAsJavaScriptException();
-        return state;
-      }
-    } else {
-      qc2->import(ss, format);
-
-      // check if the number of qubits is the same for both algorithms
-      if (ready1 && qc1->getNqubits() != qc2->getNqubits()) {
-        // algo1 is already loaded (because ready2 is true), so we reset algo2
-        qc2->reset();
-        ready2 = false;
-        std::stringstream msg;
-        msg << "Number of qubits don't match! This algorithm needs "
-            << qc1->getNqubits() << " qubits.";
-        Napi::Error::New(env, msg.str()).ThrowAsJavaScriptException();
-        return state;
-      }
-    }
-    // resize the DD package so that it can manage the current circuit size
-    dd->resize(qc1->getNqubits());
+    return loadState(env, engine->load(std::move(args->algo), args->formatCode,
+                                       args->opNum, args->process,
+                                       args->algo1));
   } catch (const std::exception& e) {
-    const auto* msg = e.what();
-    std::cout << "Exception while loading the algorithm: " << msg << "\n";
-    Napi::Error::New(env, std::string(msg)).ThrowAsJavaScriptException();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return state;
   }
+}
 
-  // if sim hasn't been set yet or only one algorithm is loaded (meaning the
-  // other isn't ready), we create its initial state/matrix
-  if (sim.p == nullptr || (algo1 && !ready2) || (!algo1 && !ready1)) {
-    // sim = dd->makeZeroState(qc->getNqubits());
-    if (algo1)
-      sim = dd->createInitialMatrix(qc1->ancillary);
-    else
-      sim = dd->createInitialMatrix(qc2->ancillary);
-    dd->incRef(sim);
-
-  } else { // reset the previously loaded algorithm if process is true
-    if (process) {
-      try {
-        if (algo1 && ready1)
-          stepToStart(true);
-        else if (!algo1 && ready2)
-          stepToStart(false);
-      } catch (const std::exception& e) {
-        std::cout << "Exception while resetting algo" << (algo1 ? "1" : "2")
-                  << e.what() << std::endl;
-        std::string err(e.what());
-        Napi::Error::New(
-            env, "Something went wrong with resetting the old algorithm.\n"
-                 "Please try to load the algorithm again!" +
-                     err)
-            .ThrowAsJavaScriptException();
-        return state;
-      }
-    }
-  }
+/**Same as load, but imports and processes the algorithm on a worker thread.
+ *
+ * @return a Promise resolving to the same object load returns
+ */
+Napi::Value QDDVer::LoadAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto args = parseLoadArguments(info);
+  if (!args.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<std::size_t>::Queue(
+      Value(),
+      [engine, args = *args]() mutable {
+        const auto lock = engine->lock();
+        return engine->load(std::move(args.algo), args.formatCode, args.opNum,
+                            args.process, args.algo1);
+      },
+      loadState);
+}
 
-  // re-initialize some variables (though depending on opNum they might change
-  // in the next lines)
-  if (algo1) {
-    ready1     = true;
-    atInitial1 = true;
-    atEnd1     = false;
-    iterator1  = qc1->begin();
-    position1  = 0;
-  } else {
-    ready2     = true;
-    atInitial2 = true;
-    atEnd2     = false;
-    iterator2  = qc2->begin();
-    position2  = 0;
-  }
-
-  if (algo1 && opNum > qc1->getNops())
-    opNum = static_cast<unsigned int>(qc1->getNops());
-  else if (!algo1 && opNum > qc2->getNops())
-    opNum = static_cast<unsigned int>(qc2->getNops());
-
-  if (opNum > 0) {
-    if (algo1)
-      atInitial1 = false;
-    else
-      atInitial2 = false;
-    if (process) {
-      // apply some operations
-      for (unsigned int i = 0; i < opNum; i++)
-        stepForward(algo1);
-
-    } else {
-      if (algo1) {
-        // just advance the iterator so it points to the operations where we
-        // stopped before the edit
-        for (unsigned int i = 0; i < opNum; i++)
-          iterator1++;
-        position1 = opNum;
-      } else {
-        // just advance the iterator so it points to the operations where we
-        // stopped before the edit
-        for (unsigned int i = 0; i < opNum; i++)
-          iterator2++;
-        position2 = opNum;
-      }
-    }
+/**Starts streaming an algorithm in chunks (see QDDVis::BeginLoad).
+ *
+ * @param info has no parameters
+ */
+void QDDVer::BeginLoad([[maybe_unused]] const Napi::CallbackInfo& info) {
+  streamedAlgorithm = std::string{};
+  streaming         = true;
+  engine->setStreamedBytes(0);
+}
+
+/**Appends the next chunk of the streamed algorithm.
+ *
+ * @param info has one parameter: the chunk (Buffer with UTF-8 text or String)
+ */
+void QDDVer::PushChunk(const Napi::CallbackInfo& info) {
+  if (!streaming) {
+    Napi::Error::New(info.Env(), "No algorithm is being streamed!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  // a single algorithm may take up the whole memory budget of the sessions;
+  // the next access of the session evicts others if the budget is exceeded
+  const auto maxSize = SessionRegistry::instance().getMemoryBudget();
+  if (!appendChunk(info, streamedAlgorithm, maxSize)) {
+    streamedAlgorithm = std::string{};
+    streaming         = false;
   }
+  engine->setStreamedBytes(streamedAlgorithm.capacity());
+}
 
-  if (algo1)
-    state.Set("numOfOperations",
-              Napi::Number::New(env, static_cast<double>(qc1->getNops())));
-  else
-    state.Set("numOfOperations",
-              Napi::Number::New(env, static_cast<double>(qc2->getNops())));
-  return state;
+/**Finishes streaming the algorithm and imports and processes it on a worker
+ * thread, just like loadAsync.
+ *
+ * @param info same as for load, but without the algorithm
+ * @return a Promise resolving to the same object load returns
+ */
+Napi::Value QDDVer::EndLoadAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (!streaming) {
+    Napi::Error::New(env, "No algorithm is being streamed!")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  auto args = parseLoadArguments(info, false);
+  if (!args.has_value())
+    return env.Undefined();
+  // the text is moved into the engine, which keeps it as the loaded algorithm
+  args->algo        = std::move(streamedAlgorithm);
+  streamedAlgorithm = std::string{};
+  streaming         = false;
+
+  auto* engine = this->engine.get();
+  return AsyncTask<std::size_t>::Queue(
+      Value(),
+      [engine, args = std::move(*args)]() mutable {
+        const auto lock = engine->lock();
+        // from now on, the text is counted as the algorithm of the engine
+        engine->setStreamedBytes(0);
+        return engine->load(std::move(args.algo), args.formatCode, args.opNum,
+                            args.process, args.algo1);
+      },
+      loadState);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -401,67 +531,44 @@ Napi::Value QDDVer::Load(const Napi::CallbackInfo& info) {
  * occurred)
  */
 Napi::Value QDDVer::ToStart(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-
-  if (info.Length() < 1) {
-    Napi::RangeError::New(env, "Need 1 (bool) argument!")
-        .ThrowAsJavaScriptException();
-  }
-  if (!info[0].IsBoolean()) { // algo1
-    Napi::TypeError::New(env, "arg1: Boolean expected!")
-        .ThrowAsJavaScriptException();
-  }
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1) {
-    if (!ready1) {
-      // Napi::Error::New(env, "No algorithm loaded as
-      // algo1!").ThrowAsJavaScriptException();
-      std::cout << "not ready 1" << std::endl;
-      return Napi::Boolean::New(env, false);
-    } else if (qc1->empty()) {
-      std::cout << "empty 2" << std::endl;
-      return Napi::Boolean::New(env, false);
-    } else if (atInitial1) {
-      std::cout << "at initial 2" << std::endl;
-      return Napi::Boolean::New(env, false); // nothing changed
-    }
-
-    atEnd1 = false; // now we are definitely not at the end (if there were no
-                    // operation, so atInitial
-    // and atEnd could be true at the same time, if(qc-empty) would already have
-    // returned
-
-  } else {
-    if (!ready2) {
-      // Napi::Error::New(env, "No algorithm loaded as
-      // algo2!").ThrowAsJavaScriptException();
-      std::cout << "not ready 2" << std::endl;
-      return Napi::Boolean::New(env, false);
-    } else if (qc2->empty()) {
-      std::cout << "empty 2" << std::endl;
-      return Napi::Boolean::New(env, false);
-    } else if (atInitial2) {
-      std::cout << "atInitial 2" << std::endl;
-      return Napi::Boolean::New(env, false); // nothing changed
-    }
-
-    atEnd2 = false; // now we are definitely not at the end (if there were no
-                    // operation, so atInitial
-    // and atEnd could be true at the same time, if(qc-empty) would already have
-    // returned
-  }
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return Napi::Boolean::New(env, false);
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return Napi::Boolean::New(env, false);
 
   try {
-    stepToStart(algo1);
-    return Napi::Boolean::New(env, true); // something changed
-
+    return Napi::Boolean::New(env, engine->toStart(*algo1));
   } catch (const std::exception& e) {
-    std::cout << "Exception while going back to the start!" << std::endl;
-    std::cout << e.what() << std::endl;
-    return Napi::Boolean::New(env, false); // nothing changed
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return Napi::Boolean::New(env, false);
   }
 }
 
+/**Same as toStart, but goes back on a worker thread.
+ *
+ * @return a Promise resolving to the boolean toStart returns
+ */
+Napi::Value QDDVer::ToStartAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<bool>::Queue(
+      Value(),
+      [engine, algo1 = *algo1]() {
+        const auto lock = engine->lock();
+        return engine->toStart(algo1);
+      },
+      [](Napi::Env env, const bool& changed) {
+        return Napi::Boolean::New(env, changed);
+      });
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /**Goes back to the previous step of the simulation process by applying the
  * inverse of the last processed operation/DD. If atInitial is true, nothing
@@ -473,65 +580,42 @@ Napi::Value QDDVer::ToStart(const Napi::CallbackInfo& info) {
  * occurred)
  */
 Napi::Value QDDVer::Prev(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-
-  if (info.Length() < 1) {
-    Napi::RangeError::New(env, "Need 1 (bool) argument!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsBoolean()) { // algo1
-    Napi::TypeError::New(env, "arg1: Boolean expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1) {
-    if (!ready1) {
-      Napi::Error::New(env, "No algorithm loaded as algo1!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc1->empty()) {
-      return state;
-    }
-
-    if (atEnd1) {
-      atEnd1 = false;
-    } else if (atInitial1) {
-      return state; // we can't go any further back
-    }
-  } else {
-    if (!ready2) {
-      Napi::Error::New(env, "No algorithm loaded as algo2!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc2->empty()) {
-      return state;
-    }
-
-    if (atEnd2) {
-      atEnd2 = false;
-    } else if (atInitial2) {
-      return state; // we can't go any further back
-    }
-  }
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return prevState(env, {});
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return prevState(env, {});
 
   try {
-    state.Set("changed", true); // something changed
-    stepBack(algo1); // go back to the start before the last processed operation
-
-    return state;
-
+    return prevState(env, engine->prev(*algo1));
   } catch (const std::exception& e) {
-    std::cout << "Exception while getting the current operation {src: prev}!"
-              << e.what() << std::endl;
-    std::cout << e.what() << std::endl;
-    return state;
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return prevState(env, {});
   }
 }
 
+/**Same as prev, but goes back on a worker thread.
+ *
+ * @return a Promise resolving to the same object prev returns
+ */
+Napi::Value QDDVer::PrevAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::StepResult>::Queue(
+      Value(),
+      [engine, algo1 = *algo1]() {
+        const auto lock = engine->lock();
+        return engine->prev(algo1);
+      },
+      prevState);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /**Goes forward to the next step of the simulation process by applying the
  * current operation/DD. If atEnd is true, nothing happens instead. atInitial
@@ -542,71 +626,42 @@ Napi::Value QDDVer::Prev(const Napi::CallbackInfo& info) {
  * occurred)
  */
 Napi::Value QDDVer::Next(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-
-  if (info.Length() < 1) {
-    Napi::RangeError::New(env, "Need 1 (bool) argument!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsBoolean()) { // algo1
-    Napi::TypeError::New(env, "arg1: Boolean expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1) {
-    if (!ready1) {
-      Napi::Error::New(env, "No algorithm loaded as algo1!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc1->empty()) {
-      return state;
-    }
-
-    if (atInitial1) {
-      atInitial1 = false;
-    } else if (atEnd1) {
-      return state;
-    }
-  } else {
-    if (!ready2) {
-      Napi::Error::New(env, "No algorithm loaded as algo2!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc2->empty()) {
-      return state;
-    }
-
-    if (atInitial2) {
-      atInitial2 = false;
-    } else if (atEnd2) {
-      return state;
-    }
-  }
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return stepState(env, {});
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return stepState(env, {});
 
   try {
-    state.Set("changed", Napi::Boolean::New(env, true));
-    stepForward(algo1); // process the next operation
-    auto& iterator = algo1 ? iterator1 : iterator2;
-    auto& qc       = algo1 ? qc1 : qc2;
-    if (iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
-                                  (*iterator)->getType() == qc::Reset)) {
-      state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-    }
-    return state;
-
+    return stepState(env, engine->next(*algo1));
   } catch (const std::exception& e) {
-    std::cout << "Exception while getting the current operation {src: next}!"
-              << std::endl;
-    std::cout << e.what() << std::endl;
-    return state;
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return stepState(env, {});
   }
 }
 
+/**Same as next, but applies the operation on a worker thread.
+ *
+ * @return a Promise resolving to the same object next returns
+ */
+Napi::Value QDDVer::NextAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::StepResult>::Queue(
+      Value(),
+      [engine, algo1 = *algo1]() {
+        const auto lock = engine->lock();
+        return engine->next(algo1);
+      },
+      stepState);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /**Processes all operations until the iterator points to the very end.
  * atEnd will be true and in most cases atInitial will be false (special case
@@ -617,80 +672,42 @@ Napi::Value QDDVer::Next(const Napi::CallbackInfo& info) {
  * occurred)
  */
 Napi::Value QDDVer::ToEnd(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-  state.Set("barrier", Napi::Boolean::New(env, false));
-
-  if (info.Length() < 1) {
-    Napi::RangeError::New(env, "Need 1 (bool) argument!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsBoolean()) { // algo1
-    Napi::TypeError::New(env, "arg1: Boolean expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1) {
-    if (!ready1) {
-      Napi::Error::New(env, "No algorithm loaded as algo1!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc1->empty() || atEnd1) {
-      return state;
-    }
-    atInitial1 = false; // now we are definitely not at the beginning (if there
-                        // were no operation, so atInitial
-    // and atEnd could be true at the same time, if(qc-empty) would already have
-    // returned
-
-  } else {
-    if (!ready2) {
-      Napi::Error::New(env, "No algorithm loaded as algo2!")
-          .ThrowAsJavaScriptException();
-      return state;
-    } else if (qc2->empty() || atEnd2) {
-      return state;
-    }
-    atInitial2 = false; // now we are definitely not at the beginning (if there
-                        // were no operation, so atInitial
-                        //  and atEnd could be true at the same time,
-                        //  if(qc-empty) would already have returned
-  }
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return toEndState(env, {});
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return toEndState(env, {});
 
   try {
-    state.Set("changed", Napi::Boolean::New(env, true)); // something changed
-    unsigned long long nops     = 0;
-    auto&              iterator = algo1 ? iterator1 : iterator2;
-    auto&              atEnd    = algo1 ? atEnd1 : atEnd2;
-    while (!atEnd) {
-      if ((*iterator)->getType() == qc::Measure ||
-          (*iterator)->getType() == qc::Reset) {
-        state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-        break;
-      } else if ((*iterator)->getType() == qc::Barrier) {
-        ++nops;
-        stepForward(algo1); // process the barrier
-        state.Set("barrier", Napi::Boolean::New(env, true));
-        break;
-      } else {
-        ++nops;
-        stepForward(algo1); // process the next operation
-      }
-    }
-    state.Set("nops", Napi::Number::New(env, static_cast<double>(nops)));
-    return state;
-
+    return toEndState(env, engine->toEnd(*algo1));
   } catch (const std::exception& e) {
-    std::cout << "Exception while going to the end!" << std::endl;
-    std::cout << e.what() << std::endl;
-    return state;
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return toEndState(env, {});
   }
 }
 
+/**Same as toEnd, but processes the operations on a worker thread.
+ *
+ * @return a Promise resolving to the same object toEnd returns
+ */
+Napi::Value QDDVer::ToEndAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env   = info.Env();
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::ToEndResult>::Queue(
+      Value(),
+      [engine, algo1 = *algo1]() {
+        const auto lock = engine->lock();
+        return engine->toEnd(algo1);
+      },
+      toEndState);
+}
+
 /**Depending on the current position of the iterator and the given parameter
  * this function either applies inverse operations/DDs like Prev or
  * operations/DDs normally like Next. atInitial and atEnd could be anything
@@ -707,82 +724,144 @@ Napi::Value QDDVer::ToLine(const Napi::CallbackInfo& info) {
   Napi::Env         env = info.Env();
   Napi::HandleScope scope(env);
 
-  // check if the correct parameters have been passed
-  if (info.Length() < 2) {
-    Napi::RangeError::New(env, "Need 2 (unsigned int, bool) arguments!")
-        .ThrowAsJavaScriptException();
+  const auto args = parseLineArguments(info);
+  if (!args.has_value())
     return Napi::Boolean::New(env, false);
-  }
-  if (!info[0].IsNumber()) { // line number/position
-    Napi::TypeError::New(env, "arg1: unsigned int expected!")
-        .ThrowAsJavaScriptException();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
     return Napi::Boolean::New(env, false);
-  }
-  if (!info[1].IsBoolean()) { // algo1
-    Napi::TypeError::New(env, "arg1: Boolean expected!")
-        .ThrowAsJavaScriptException();
-  }
 
-  auto       param = static_cast<unsigned int>(info[0].As<Napi::Number>());
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1) {
-    if (param > qc1->getNops())
-      // we can't go further than to the end
-      param = static_cast<unsigned int>(qc1->getNops());
-  } else {
-    if (param > qc2->getNops())
-      // we can't go further than to the end
-      param = static_cast<unsigned int>(qc2->getNops());
+  try {
+    return Napi::Boolean::New(env,
+                              engine->toLine(args->targetPos, args->algo1));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return Napi::Boolean::New(env, false);
   }
-  const unsigned int targetPos = param;
+}
 
-  try {
-    if (algo1) {
-      if (position1 == targetPos)
-        return Napi::Boolean::New(env, false); // nothing changed
-
-      // only one of the two loops can be entered
-      while (position1 > targetPos)
-        stepBack(true);
-      while (position1 < targetPos)
-        stepForward(true);
-
-      atInitial1 = false;
-      atEnd1     = false;
-      if (position1 == 0)
-        atInitial1 = true;
-      if (position1 == qc1->getNops())
-        atEnd1 = true;
-
-    } else {
-      if (position2 == targetPos)
-        return Napi::Boolean::New(env, false); // nothing changed
-
-      // only one of the two loops can be entered
-      while (position2 > targetPos)
-        stepBack(false);
-      while (position2 < targetPos)
-        stepForward(false);
-
-      atInitial2 = false;
-      atEnd2     = false;
-      if (position2 == 0)
-        atInitial2 = true;
-      if (position2 == qc2->getNops())
-        atEnd2 = true;
+/**Same as toLine, but processes the operations on a worker thread.
+ *
+ * @return a Promise resolving to the same value toLine returns
+ */
+Napi::Value QDDVer::ToLineAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto args = parseLineArguments(info);
+  if (!args.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<bool>::Queue(
+      Value(),
+      [engine, args = *args]() {
+        const auto lock = engine->lock();
+        return engine->toLine(args.targetPos, args.algo1);
+      },
+      [](Napi::Env env, bool& changed) {
+        return Napi::Boolean::New(env, changed);
+      });
+}
+
+/**Applies all remaining operations of both algorithms on a worker thread,
+ * interleaving the two circuits according to the given strategy, so the
+ * functionality stays small if they are equivalent.
+ *
+ * @param info has one parameter: the strategy ("onetoone" alternates between
+ * the circuits, "proportional" follows the ratio of their sizes, "lookahead"
+ * picks the operation resulting in the smaller DD, "parallel" builds both
+ * functionalities concurrently on two threads and combines them at the end)
+ * @return a Promise resolving to an object with changed, the number of
+ * operations applied of each algorithm (nops1, nops2) and the resulting
+ * equivalence (see getEquivalenceAsync)
+ */
+Napi::Value QDDVer::CheckEquivalenceAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env      = info.Env();
+  const auto strategy = parseStrategyArgument(info);
+  if (!strategy.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::CheckResult>::Queue(
+      Value(),
+      [engine, strategy = *strategy]() {
+        const auto lock = engine->lock();
+        return engine->checkEquivalence(strategy);
+      },
+      checkState);
+}
+
+/**Compares the current functionality with the identity on a worker thread,
+ * without exporting the DD.
+ *
+ * @param info optionally takes the tolerance for comparing the entries
+ * @return a Promise resolving to an object with the equivalence
+ * ("equivalent", "equivalent_up_to_global_phase" or "not_equivalent"),
+ * whether all operations of both algorithms have been applied (complete) and,
+ * if not equivalent, an input basis state that is not mapped to itself
+ * (counterexample, qubit 0 is the rightmost character)
+ */
+Napi::Value QDDVer::GetEquivalenceAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env       = info.Env();
+  auto      tolerance = VerificationEngine::EQUIVALENCE_TOLERANCE;
+  if (info.Length() > 0 && !info[0].IsUndefined()) {
+    if (!info[0].IsNumber()) { // tolerance
+      Napi::TypeError::New(env, "arg1: Number expected!")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
     }
+    tolerance = info[0].As<Napi::Number>().DoubleValue();
+  }
 
-    return Napi::Boolean::New(env, true); // something changed
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::EquivalenceResult>::Queue(
+      Value(),
+      [engine, tolerance]() {
+        const auto lock = engine->lock();
+        return engine->equivalence(tolerance);
+      },
+      equivalenceState);
+}
 
-  } catch (const std::exception& e) {
-    std::stringstream ss{};
-    ss << "Exception while going from " << (algo1 ? position1 : position2)
-       << " to " << targetPos << ": " << e.what() << "\n";
-    const auto msg = ss.str();
-    std::cout << msg << std::endl;
-    Napi::Error::New(env, msg).ThrowAsJavaScriptException();
-    return Napi::Boolean::New(env, false);
+/**Simulates both algorithms on random input basis states in parallel and
+ * compares the resulting states, which catches most non-equivalent circuits
+ * long before their functionality would be built.
+ *
+ * @param info optionally takes the number of stimuli and a seed for the
+ * random inputs
+ * @return a Promise resolving to an object with passed (whether all stimuli
+ * led to the same state), the number of simulated stimuli, the lowest
+ * fidelity and, if not passed, the failing input basis state (counterexample,
+ * qubit 0 is the rightmost character)
+ */
+Napi::Value QDDVer::SimulationCheckAsync(const Napi::CallbackInfo& info) {
+  Napi::Env     env     = info.Env();
+  std::size_t   stimuli = VerificationEngine::DEFAULT_STIMULI;
+  std::uint64_t seed    = std::random_device{}();
+  if (info.Length() > 0 && !info[0].IsUndefined()) {
+    if (!info[0].IsNumber()) { // number of stimuli
+      Napi::TypeError::New(env, "arg1: unsigned int expected!")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    stimuli = info[0].As<Napi::Number>().Uint32Value();
   }
+  if (info.Length() > 1 && !info[1].IsUndefined()) {
+    if (!info[1].IsNumber()) { // seed
+      Napi::TypeError::New(env, "arg2: unsigned int expected!")
+          .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    seed = info[1].As<Napi::Number>().Uint32Value();
+  }
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::SimulationCheckResult>::Queue(
+      Value(),
+      [engine, stimuli, seed]() {
+        const auto lock = engine->lock();
+        return engine->simulationCheck(stimuli, seed);
+      },
+      simulationCheckState);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -793,34 +872,86 @@ Napi::Value QDDVer::ToLine(const Napi::CallbackInfo& info) {
  * .dot-format
  */
 Napi::Value QDDVer::GetDD(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  if (!ready1 && !ready2) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
     return Napi::String::New(env, "-1");
-  }
 
-  std::stringstream ss{};
   try {
-    dd::toDot(sim, ss, this->showColors, this->showEdgeLabels,
-              this->showClassic, false, this->usePolarCoordinates);
-    std::string str = ss.str();
-    state.Set("dot", Napi::String::New(env, str));
-    state.Set("amplitudes", Napi::Float32Array::New(env, 0));
-    return state;
-
+    return ddState(env, engine->getDD());
   } catch (const std::exception& e) {
-    std::stringstream sserr{};
-    sserr << "Exception while getting the DD: " << e.what() << "\n";
-    sserr << "The values of the Flags are: " << this->showColors << ", "
-          << this->showEdgeLabels << ", " << this->showClassic << ", "
-          << this->usePolarCoordinates << "\n";
-    const auto err = sserr.str();
-    Napi::Error::New(env, err).ThrowAsJavaScriptException();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return Napi::String::New(env, "-1");
   }
 }
 
+/**Same as getDD, but exports the DD on a worker thread.
+ *
+ * @return a Promise resolving to the same object getDD returns
+ */
+Napi::Value
+QDDVer::GetDDAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<std::string>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->getDD();
+      },
+      ddState);
+}
+
+/**Saves both algorithms with their positions, the export options and the
+ * current functionality to a binary file on a worker thread.
+ *
+ * @param info has a string argument (path of the file)
+ * @return a Promise resolving to true once the file is written
+ */
+Napi::Value QDDVer::SaveStateAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto path = parsePathArgument(info);
+  if (!path.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<bool>::Queue(
+      Value(),
+      [engine, path = *path]() {
+        const auto lock = engine->lock();
+        sessionfile::save(path,
+                          [engine](std::ostream& os) { engine->save(os); });
+        return true;
+      },
+      [](Napi::Env env, const bool& saved) {
+        return Napi::Boolean::New(env, saved);
+      });
+}
+
+/**Replaces both algorithms with the ones saved by saveStateAsync on a worker
+ * thread. The functionality is read from the file instead of being constructed
+ * again.
+ *
+ * @param info has a string argument (path of the file)
+ * @return a Promise resolving to {algo1, algo2}, each {ready, algo, format,
+ * position, numOfOperations}
+ */
+Napi::Value QDDVer::RestoreStateAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto path = parsePathArgument(info);
+  if (!path.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<VerificationEngine::RestoreResult>::Queue(
+      Value(),
+      [engine, path = *path]() {
+        auto       ifs  = sessionfile::open(path);
+        const auto lock = engine->lock();
+        return engine->restore(ifs);
+      },
+      restoreState);
+}
+
 /**Updates the three fields of this object that determine with which options the
  * DD should be exported (on the next GetDD-call).
  *
@@ -855,20 +986,26 @@ void QDDVer::UpdateExportOptions(const Napi::CallbackInfo& info) {
     return;
   }
 
-  this->showColors          = static_cast<bool>(info[0].As<Napi::Boolean>());
-  this->showEdgeLabels      = static_cast<bool>(info[1].As<Napi::Boolean>());
-  this->showClassic         = static_cast<bool>(info[2].As<Napi::Boolean>());
-  this->usePolarCoordinates = static_cast<bool>(info[3].As<Napi::Boolean>());
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return;
+  engine->updateExportOptions(static_cast<bool>(info[0].As<Napi::Boolean>()),
+                              static_cast<bool>(info[1].As<Napi::Boolean>()),
+                              static_cast<bool>(info[2].As<Napi::Boolean>()),
+                              static_cast<bool>(info[3].As<Napi::Boolean>()));
 }
 
 Napi::Value QDDVer::GetExportOptions(const Napi::CallbackInfo& info) {
   Napi::Env    env   = info.Env();
   Napi::Object state = Napi::Object::New(env);
 
-  state.Set("colored", this->showColors);
-  state.Set("edgeLabels", this->showEdgeLabels);
-  state.Set("classic", this->showClassic);
-  state.Set("polar", this->usePolarCoordinates);
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return state;
+  state.Set("colored", engine->getShowColors());
+  state.Set("edgeLabels", engine->getShowEdgeLabels());
+  state.Set("classic", engine->getShowClassic());
+  state.Set("polar", engine->getUsePolarCoordinates());
   return state;
 }
 
@@ -878,12 +1015,15 @@ Napi::Value QDDVer::GetExportOptions(const Napi::CallbackInfo& info) {
  * @return true if an algorithm has been loaded, false otherwise
  */
 Napi::Value QDDVer::IsReady(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return Napi::Boolean::New(env, false);
 
   if (info.Length() < 1) {
     // if no parameter is given, check if one of the two algos are ready,
     // meaning a DD can be shown
-    return Napi::Boolean::New(env, this->ready1 || this->ready2);
+    return Napi::Boolean::New(env, engine->isReady());
   }
   if (!info[0].IsBoolean()) { // algo1
     Napi::TypeError::New(env, "arg1: Boolean expected!")
@@ -891,28 +1031,107 @@ Napi::Value QDDVer::IsReady(const Napi::CallbackInfo& info) {
   }
 
   const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1)
-    return Napi::Boolean::New(env, this->ready1);
-  else
-    return Napi::Boolean::New(env, this->ready2);
+  return Napi::Boolean::New(env, engine->isReady(algo1));
 }
 
 void QDDVer::Unready(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-
   if (info.Length() < 1) {
     // if no parameter is given, check if one of the two algos are ready,
     // meaning a DD can be shown
     return;
   }
-  if (!info[0].IsBoolean()) { // algo1
+  const auto algo1 = parseAlgoArgument(info);
+  if (!algo1.has_value())
+    return;
+
+  if (const auto lock = tryLockEngine(info.Env(), *engine); lock.owns_lock())
+    engine->unready(*algo1);
+}
+
+/**Enables or disables applying the functionality DDs of whole measurement-free
+ * segments in multi-step moves. The DDs are built by prepareSegmentsAsync.
+ *
+ * @param info has one boolean argument (enabled)
+ */
+void QDDVer::SetSegmentMatrices(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() != 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  if (!info[0].IsBoolean()) { // enabled
     Napi::TypeError::New(env, "arg1: Boolean expected!")
         .ThrowAsJavaScriptException();
     return;
   }
-  const auto algo1 = static_cast<bool>(info[0].As<Napi::Boolean>());
-  if (algo1)
-    this->ready1 = false;
-  else
-    this->ready2 = false;
+
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->setSegmentMatrices(static_cast<bool>(info[0].As<Napi::Boolean>()));
+}
+
+/**Enables or disables recording the duration of building the DD of every
+ * applied operation, of the multiplication and of the garbage collection as
+ * well as the size of the resulting DD and the hit ratio of the compute table.
+ * Enabling discards the statistics recorded so far.
+ *
+ * @param info has one boolean argument (enabled)
+ */
+void QDDVer::SetProfiling(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() != 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  if (!info[0].IsBoolean()) { // enabled
+    Napi::TypeError::New(env, "arg1: Boolean expected!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->setProfiling(static_cast<bool>(info[0].As<Napi::Boolean>()));
+}
+
+/**
+ * @param info has no parameters
+ * @return the statistics recorded while profiling was enabled as compact JSON
+ * (see Profiler::toJson)
+ */
+Napi::Value QDDVer::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return env.Undefined();
+  return Napi::String::New(env, engine->getStats());
+}
+
+/**Builds the functionality DDs of all segments of the loaded circuits that do
+ * not have one yet on a worker thread. The lock is released after every
+ * segment, so other requests of the session are not held up in the meantime.
+ *
+ * @param info has no parameters
+ * @return a Promise resolving to the number of processed segments
+ */
+Napi::Value
+QDDVer::PrepareSegmentsAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<std::size_t>::Queue(
+      Value(),
+      [engine]() {
+        std::size_t processed = 0;
+        while (true) {
+          const auto lock = engine->lock();
+          if (!engine->prepareSegment())
+            break;
+          ++processed;
+        }
+        return processed;
+      },
+      [](Napi::Env env, std::size_t& processed) -> Napi::Value {
+        return Napi::Number::New(env, static_cast<double>(processed));
+      });
 }
@@ -7,10 +7,9 @@
 #ifndef QDD_VIS_QDDVER_H
 #define QDD_VIS_QDDVER_H
 
-#include "dd/Operations.hpp"
-#include "dd/Package.hpp"
-#include "ir/QuantumComputation.hpp"
+#include "VerificationEngine.h"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <napi.h>
@@ -24,11 +23,6 @@ public:
 private:
   static inline Napi::FunctionReference constructor;
 
-  //"private" methods
-  void stepForward(bool algo1); // whether it is applied on algo1 or algo2
-  void stepBack(bool algo1);    // whether it is applied on algo1 or algo2
-  void stepToStart(bool algo1); // whether it is applied on algo1 or algo2
-
   // exported ("public") methods       - return type must be Napi::Value or
   // void!
   Napi::Value GetDD(const Napi::CallbackInfo& info); // isVector: false
@@ -42,38 +36,36 @@ private:
   Napi::Value GetExportOptions(const Napi::CallbackInfo& info);
   Napi::Value IsReady(const Napi::CallbackInfo& info);
   void        Unready(const Napi::CallbackInfo& info);
+  void        SetSegmentMatrices(const Napi::CallbackInfo& info);
+  void        SetProfiling(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+  void        BeginLoad(const Napi::CallbackInfo& info);
+  void        PushChunk(const Napi::CallbackInfo& info);
 
-  // fields
-  std::unique_ptr<dd::Package<>> dd;
-  qc::MatrixDD                   sim{};
-
-  // options for the DD export
-  bool showColors          = true;
-  bool showEdgeLabels      = true;
-  bool showClassic         = false;
-  bool usePolarCoordinates = true;
+  // Promise-returning variants that run on the libuv thread pool
+  Napi::Value LoadAsync(const Napi::CallbackInfo& info);
+  Napi::Value EndLoadAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToStartAsync(const Napi::CallbackInfo& info);
+  Napi::Value PrevAsync(const Napi::CallbackInfo& info);
+  Napi::Value NextAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToEndAsync(const Napi::CallbackInfo& info);
+  Napi::Value PrepareSegmentsAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToLineAsync(const Napi::CallbackInfo& info);
+  Napi::Value CheckEquivalenceAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetEquivalenceAsync(const Napi::CallbackInfo& info);
+  Napi::Value SimulationCheckAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetDDAsync(const Napi::CallbackInfo& info);
+  Napi::Value SaveStateAsync(const Napi::CallbackInfo& info);
+  Napi::Value RestoreStateAsync(const Napi::CallbackInfo& info);
 
-  std::unique_ptr<qc::QuantumComputation> qc1;
-  std::vector<std::unique_ptr<qc::Operation>>::iterator
-               iterator1{};   // operations of algo1
-  unsigned int position1 = 0; // current position of iterator1
-
-  bool ready1 = false; // true if algo1 is valid
-  bool atInitial1 =
-      true; // whether we're currently before the first operation of algo1
-  bool atEnd1 =
-      false; // whether we're currently after the last operation of algo1
-
-  std::unique_ptr<qc::QuantumComputation> qc2;
-  std::vector<std::unique_ptr<qc::Operation>>::iterator
-               iterator2{};   // operations of algo2
-  unsigned int position2 = 0; // current position of iterator2
+  // fields
+  // shared with the SessionRegistry if the object belongs to a session
+  std::shared_ptr<VerificationEngine> engine;
 
-  bool ready2 = false; // true if algo2 is valid
-  bool atInitial2 =
-      true; // whether we're currently before the first operation of algo2
-  bool atEnd2 =
-      false; // whether we're currently after the last operation of algo2
+  // text received by pushChunk since the last beginLoad; its size is counted
+  // as memory usage of the session (see VerificationEngine::setStreamedBytes)
+  std::string streamedAlgorithm{};
+  bool        streaming = false;
 };
 
 #endif // QDD_VIS_QDDVER_H
@@ -6,8 +6,497 @@
 
 #include "QDDVis.h"
 
-#include "dd/Export.hpp"
-#include "dd/Operations.hpp"
+#include "AsyncTask.h"
+#include "SessionFile.h"
+#include "SessionRegistry.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+struct LoadArguments {
+  std::string  algo{};
+  unsigned int formatCode = 0;
+  unsigned int opNum      = 0;
+  bool         process    = false;
+};
+
+/**Checks and extracts the arguments of load/loadAsync. Throws a JavaScript
+ * exception and returns nothing if they are invalid.
+ *
+ * @param withAlgorithm false for endLoadAsync, whose arguments start with the
+ * format code since the algorithm has been streamed before
+ */
+std::optional<LoadArguments>
+parseLoadArguments(const Napi::CallbackInfo& info,
+                   const bool                withAlgorithm = true) {
+  Napi::Env  env   = info.Env();
+  const auto first = withAlgorithm ? 1U : 0U; // index of the format code
+  // check if the correct parameters have been passed
+  if (info.Length() < first + 3) {
+    Napi::RangeError::New(
+        env, withAlgorithm
+                 ? "Need 4 (String, unsigned int, unsigned int, bool) "
+                   "arguments!"
+                 : "Need 3 (unsigned int, unsigned int, bool) arguments!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (withAlgorithm && !info[0].IsString()) { // algorithm
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first].IsNumber()) { // format code (1 = QASM, 2 = Real)
+    Napi::TypeError::New(env, "arg3: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first + 1].IsNumber()) { // number of operations to immediately
+                                     // process
+    Napi::TypeError::New(env, "arg2: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[first + 2].IsBoolean()) { // whether operations should be processed
+                                      // while advancing the iterator to opNum
+                                      // or not (true = new simulation; false =
+                                      // continue simulation)
+    Napi::TypeError::New(env, "arg3: boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+
+  LoadArguments args{};
+  if (withAlgorithm)
+    args.algo = info[0].As<Napi::String>().Utf8Value();
+  args.formatCode = static_cast<unsigned int>(info[first].As<Napi::Number>());
+  // at this point opNum may be bigger than the number of operations the
+  // algorithm has!
+  args.opNum   = static_cast<unsigned int>(info[first + 1].As<Napi::Number>());
+  args.process = static_cast<bool>(info[first + 2].As<Napi::Boolean>());
+  return args;
+}
+
+/**Appends a chunk of a streamed algorithm (Buffer or String) to the given
+ * text. Throws a JavaScript exception and returns false if the chunk is invalid
+ * or the text would get too long.
+ */
+bool appendChunk(const Napi::CallbackInfo& info, std::string& text,
+                 const std::size_t maxSize) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !(info[0].IsBuffer() || info[0].IsString())) {
+    Napi::TypeError::New(env, "arg1: Buffer or String expected!")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+
+  if (info[0].IsBuffer()) {
+    const auto chunk = info[0].As<Napi::Buffer<char>>();
+    if (text.size() + chunk.Length() > maxSize) {
+      Napi::RangeError::New(env, "The algorithm is too large!")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    text.append(chunk.Data(), chunk.Length());
+  } else {
+    const auto chunk = info[0].As<Napi::String>().Utf8Value();
+    if (text.size() + chunk.size() > maxSize) {
+      Napi::RangeError::New(env, "The algorithm is too large!")
+          .ThrowAsJavaScriptException();
+      return false;
+    }
+    text.append(chunk);
+  }
+  return true;
+}
+
+std::optional<unsigned int> parseLineArgument(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() < 1) {
+    Napi::RangeError::New(env, "Need 1 (unsigned int) argument!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[0].IsNumber()) { // line number/position
+    Napi::TypeError::New(env, "arg1: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  return static_cast<unsigned int>(info[0].As<Napi::Number>());
+}
+
+Napi::Object loadState(Napi::Env env,
+                       const SimulationEngine::LoadResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("numOfOperations",
+            Napi::Number::New(env,
+                              static_cast<double>(result.numOfOperations)));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  state.Set("noGoingBack", Napi::Boolean::New(env, result.noGoingBack));
+  return state;
+}
+
+Napi::Object toEndState(Napi::Env env,
+                        const SimulationEngine::ToEndResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  state.Set("barrier", Napi::Boolean::New(env, result.barrier));
+  state.Set("nops", Napi::Number::New(env, static_cast<double>(result.nops)));
+  return state;
+}
+
+Napi::Object toLineState(Napi::Env env,
+                         const SimulationEngine::ToLineResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("noGoingBack", Napi::Boolean::New(env, result.noGoingBack));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  state.Set("reset", Napi::Boolean::New(env, result.reset));
+  state.Set("nops", Napi::Number::New(env, static_cast<double>(result.nops)));
+  return state;
+}
+
+/**Hands the values over to JavaScript without copying them: the returned
+ * typed array is backed by an external ArrayBuffer that owns the vector.
+ */
+template <class T>
+Napi::TypedArrayOf<T> externalArray(Napi::Env env, std::vector<T>&& values) {
+  if (values.empty())
+    return Napi::TypedArrayOf<T>::New(env, 0);
+
+  const auto length = values.size();
+  auto*      owner  = new std::vector<T>(std::move(values));
+  auto       buffer = Napi::ArrayBuffer::New(
+      env, owner->data(), length * sizeof(T),
+      [](Napi::Env /*env*/, void* /*data*/, std::vector<T>* hint) {
+        delete hint;
+      },
+      owner);
+  return Napi::TypedArrayOf<T>::New(env, length, buffer, 0);
+}
+
+/**The amplitudes are a Float32Array (real and imaginary part alternating). For
+ * sparse and top-k exports, indices is a BigUint64Array with the basis states
+ * the amplitudes belong to.
+ */
+Napi::Object amplitudeState(Napi::Env env, SimulationEngine::ExportResult& dd) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("nqubits", Napi::Number::New(env, static_cast<double>(dd.nqubits)));
+  state.Set("amplitudes", externalArray(env, std::move(dd.amplitudes)));
+  if (dd.sparse)
+    state.Set("indices", externalArray(env, std::move(dd.indices)));
+  return state;
+}
+
+Napi::Object ddState(Napi::Env env, SimulationEngine::ExportResult& dd) {
+  Napi::Object state = amplitudeState(env, dd);
+  state.Set("dot", Napi::String::New(env, dd.dot));
+  return state;
+}
+
+Napi::Object graphEdgeObject(Napi::Env                                 env,
+                             const GraphModel<dd::vNode>::GraphEdge& edge) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("target", Napi::Number::New(env, static_cast<double>(edge.target)));
+  obj.Set("re", Napi::Number::New(env, edge.weight.real()));
+  obj.Set("im", Napi::Number::New(env, edge.weight.imag()));
+  return obj;
+}
+
+Napi::Array
+graphNodeArray(Napi::Env                                             env,
+               const std::vector<GraphModel<dd::vNode>::GraphNode>& nodes) {
+  auto array = Napi::Array::New(env, nodes.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    Napi::Object node = Napi::Object::New(env);
+    node.Set("id", Napi::Number::New(env, static_cast<double>(nodes[i].id)));
+    node.Set("qubit", Napi::Number::New(env, nodes[i].qubit));
+    auto edges = Napi::Array::New(env, nodes[i].edges.size());
+    for (std::size_t j = 0; j < nodes[i].edges.size(); ++j)
+      edges.Set(static_cast<uint32_t>(j),
+                graphEdgeObject(env, nodes[i].edges[j]));
+    node.Set("edges", edges);
+    array.Set(static_cast<uint32_t>(i), node);
+  }
+  return array;
+}
+
+/**Node ids are numbers, the terminal has id 0. Added nodes are listed after
+ * the nodes they point to.
+ */
+Napi::Object graphDiffState(Napi::Env                          env,
+                            const SimulationEngine::GraphDiff& diff) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("reset", Napi::Boolean::New(env, diff.reset));
+  state.Set("root", graphEdgeObject(env, diff.root));
+  state.Set("added", graphNodeArray(env, diff.added));
+  state.Set("changed", graphNodeArray(env, diff.changed));
+  auto removed = Napi::Array::New(env, diff.removed.size());
+  for (std::size_t i = 0; i < diff.removed.size(); ++i)
+    removed.Set(static_cast<uint32_t>(i),
+                Napi::Number::New(env, static_cast<double>(diff.removed[i])));
+  state.Set("removed", removed);
+  return state;
+}
+
+/**All tables are typed arrays backed by the native memory (see GraphTables).
+ */
+Napi::Object graphState(Napi::Env env, GraphTables& tables) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("nodeIds", externalArray(env, std::move(tables.nodeIds)));
+  state.Set("nodeQubits", externalArray(env, std::move(tables.nodeQubits)));
+  state.Set("edgeSources", externalArray(env, std::move(tables.edgeSources)));
+  state.Set("edgeTargets", externalArray(env, std::move(tables.edgeTargets)));
+  state.Set("edgeIndices", externalArray(env, std::move(tables.edgeIndices)));
+  state.Set("edgeWeights", externalArray(env, std::move(tables.edgeWeights)));
+  state.Set("polar", Napi::Boolean::New(env, tables.polar));
+  return state;
+}
+
+/**Extracts the optional reset flag getDDDiff/getDDDiffAsync take. Throws a
+ * JavaScript exception and returns nothing if it is invalid.
+ */
+std::optional<bool> parseResetArgument(const Napi::CallbackInfo& info) {
+  if (info.Length() < 1 || info[0].IsUndefined())
+    return false;
+  if (!info[0].IsBoolean()) { // reset
+    Napi::TypeError::New(info.Env(), "arg1: Boolean expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  return static_cast<bool>(info[0].As<Napi::Boolean>());
+}
+
+/**Extracts the amplitude options from the given mode ("dense", "sparse" or
+ * "topk") and optional limit. Throws a JavaScript exception and returns
+ * nothing if they are invalid.
+ */
+std::optional<SimulationEngine::AmplitudeOptions>
+parseAmplitudeOptions(Napi::Env env, const Napi::Value& mode,
+                      const Napi::Value& limit) {
+  using AmplitudeMode = SimulationEngine::AmplitudeMode;
+  if (!mode.IsString()) {
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  const auto name = mode.As<Napi::String>().Utf8Value();
+  AmplitudeMode parsedMode{};
+  if (name == "dense") {
+    parsedMode = AmplitudeMode::Dense;
+  } else if (name == "sparse") {
+    parsedMode = AmplitudeMode::Sparse;
+  } else if (name == "topk") {
+    parsedMode = AmplitudeMode::TopK;
+  } else {
+    Napi::RangeError::New(env,
+                          "arg1: \"dense\", \"sparse\" or \"topk\" expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+
+  auto options = SimulationEngine::defaultAmplitudeOptions(parsedMode);
+  if (limit.IsUndefined())
+    return options;
+  if (!limit.IsNumber()) {
+    Napi::TypeError::New(env, "arg2: unsigned int expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  options.limit =
+      static_cast<std::size_t>(limit.As<Napi::Number>().Uint32Value());
+  return options;
+}
+
+/**Extracts the optional amplitude options getDD/getDDAsync take. Throws a
+ * JavaScript exception and returns false if they are invalid.
+ */
+bool parseExportArguments(
+    const Napi::CallbackInfo&                          info,
+    std::optional<SimulationEngine::AmplitudeOptions>& options) {
+  if (info.Length() < 1 || info[0].IsUndefined())
+    return true;
+  options = parseAmplitudeOptions(info.Env(), info[0], info[1]);
+  return options.has_value();
+}
+
+Napi::Object
+parameterObject(Napi::Env                                       env,
+                const SimulationEngine::IrreversibleParameter& parameter) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("qubit", Napi::Number::New(env, parameter.qubit));
+  obj.Set("pzero", Napi::Number::New(env, parameter.pzero));
+  obj.Set("pone", Napi::Number::New(env, parameter.pone));
+  if (parameter.cbit.has_value()) {
+    obj.Set("cbit",
+            Napi::Number::New(env, static_cast<double>(*parameter.cbit)));
+  }
+  obj.Set("count",
+          Napi::Number::New(env, static_cast<double>(parameter.count)));
+  obj.Set("total",
+          Napi::Number::New(env, static_cast<double>(parameter.total)));
+  return obj;
+}
+
+std::optional<std::string> parsePathArgument(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) { // path of the session file
+    Napi::TypeError::New(env, "arg1: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  return info[0].As<Napi::String>().Utf8Value();
+}
+
+Napi::Object restoreState(Napi::Env                              env,
+                          const SimulationEngine::RestoreResult& result) {
+  Napi::Object state = loadState(env, result.load);
+  state.Set("algo", Napi::String::New(env, result.algo));
+  state.Set("format", Napi::Number::New(env, result.formatCode));
+  state.Set("position", Napi::Number::New(env, result.position));
+  return state;
+}
+
+Napi::Object prevState(Napi::Env                           env,
+                       const SimulationEngine::PrevResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("noGoingBack", Napi::Boolean::New(env, result.noGoingBack));
+  return state;
+}
+
+Napi::Object nextState(Napi::Env                           env,
+                       const SimulationEngine::NextResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("changed", Napi::Boolean::New(env, result.changed));
+  state.Set("conductIrreversibleOperation",
+            Napi::Boolean::New(env, result.conductIrreversibleOperation));
+  state.Set("nextIsIrreversible",
+            Napi::Boolean::New(env, result.nextIsIrreversible));
+  if (result.parameter.has_value()) {
+    state.Set("parameter", parameterObject(env, *result.parameter));
+  }
+  return state;
+}
+
+Napi::Object conductState(Napi::Env                              env,
+                          const SimulationEngine::ConductResult& result) {
+  Napi::Object state = Napi::Object::New(env);
+  state.Set("finished", Napi::Boolean::New(env, result.finished));
+  if (result.parameter.has_value()) {
+    state.Set("parameter", parameterObject(env, *result.parameter));
+  }
+  return state;
+}
+
+struct ConductArguments {
+  dd::Qubit                  qubit = 0;
+  dd::fp                     pzero = 0.;
+  dd::fp                     pone  = 0.;
+  std::string                classicalValueToMeasure{};
+  std::int64_t               count = 0;
+  std::int64_t               total = 0;
+  std::optional<std::size_t> cbit{}; // not set for resets
+};
+
+/**Checks and extracts the argument of conductIrreversibleOperation(Async).
+ * Throws a JavaScript exception and returns nothing if it is invalid.
+ */
+std::optional<ConductArguments>
+parseConductArguments(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1) {
+    Napi::RangeError::New(
+        env,
+        "Need 1 Object(int, double, double, string, int, int, (int)) argument!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(
+        env,
+        "Need 1 Object(int, double, double, string, int, int, (int)) argument!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  const auto obj = info[0].ToObject();
+
+  // name, message if it is missing, message if it has the wrong type
+  const std::vector<std::array<const char*, 3>> numbers = {
+      {"qubit", "Expected qubit", "qubit: Number expected!"},
+      {"pzero", "Expected probability for 0", "pzero: Number expected!"},
+      {"pone", "Expected probability for 1", "pone: Number expected!"},
+      {"count", "Expected qubits already measured", "count: Number expected!"},
+      {"total", "Expected total qubits to measure",
+       "total: Number expected!"}};
+  for (const auto& [name, missing, wrongType] : numbers) {
+    if (!obj.Has(name)) {
+      Napi::TypeError::New(env, missing).ThrowAsJavaScriptException();
+      return std::nullopt;
+    }
+    if (!obj.Get(name).IsNumber()) {
+      Napi::TypeError::New(env, wrongType).ThrowAsJavaScriptException();
+      return std::nullopt;
+    }
+  }
+  if (!obj.Has("classicalValueToMeasure")) {
+    Napi::TypeError::New(env, "Expected desired outcome")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (!obj.Get("classicalValueToMeasure").IsString()) {
+    Napi::TypeError::New(env, "classicalValueToMeasure: String expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+  if (obj.Has("cbit") && !obj.Get("cbit").IsNumber()) {
+    Napi::TypeError::New(env, "cbit: Number expected!")
+        .ThrowAsJavaScriptException();
+    return std::nullopt;
+  }
+
+  ConductArguments args{};
+  args.qubit =
+      static_cast<dd::Qubit>(obj.Get("qubit").As<Napi::Number>().Int64Value());
+  args.pzero = obj.Get("pzero").As<Napi::Number>().DoubleValue();
+  args.pone  = obj.Get("pone").As<Napi::Number>().DoubleValue();
+  args.classicalValueToMeasure =
+      obj.Get("classicalValueToMeasure").As<Napi::String>().Utf8Value();
+  args.count = obj.Get("count").As<Napi::Number>().Int64Value();
+  args.total = obj.Get("total").As<Napi::Number>().Int64Value();
+  if (obj.Has("cbit")) { // measurement, otherwise reset
+    args.cbit = static_cast<std::size_t>(
+        obj.Get("cbit").As<Napi::Number>().Int64Value());
+  }
+  return args;
+}
+
+/**Locks the engine for a synchronous method. The main thread must not wait for
+ * an operation running on a worker thread, so if the engine is busy, an error
+ * with code "EBUSY" is thrown as JavaScript exception and the returned lock
+ * does not own the mutex.
+ */
+std::unique_lock<std::mutex> tryLockEngine(Napi::Env         env,
+                                           SimulationEngine& engine) {
+  auto lock = engine.tryLock();
+  if (!lock.owns_lock()) {
+    auto error = Napi::Error::New(env, "The session is busy, try again later!");
+    error.Value().Set("code", Napi::String::New(env, "EBUSY"));
+    error.ThrowAsJavaScriptException();
+  }
+  return lock;
+}
+} // namespace
 
 Napi::Object QDDVis::Init(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
@@ -21,12 +510,39 @@ Napi::Object QDDVis::Init(Napi::Env env, Napi::Object exports) {
        InstanceMethod("toEnd", &QDDVis::ToEnd),
        InstanceMethod("toLine", &QDDVis::ToLine),
        InstanceMethod("getDD", &QDDVis::GetDD),
+       InstanceMethod("getDDDiff", &QDDVis::GetDDDiff),
+       InstanceMethod("getGraph", &QDDVis::GetGraph),
        InstanceMethod("updateExportOptions", &QDDVis::UpdateExportOptions),
        InstanceMethod("getExportOptions", &QDDVis::GetExportOptions),
+       InstanceMethod("setGateFusion", &QDDVis::SetGateFusion),
+       InstanceMethod("setSegmentMatrices", &QDDVis::SetSegmentMatrices),
+       InstanceMethod("setProfiling", &QDDVis::SetProfiling),
+       InstanceMethod("getStats", &QDDVis::GetStats),
+       InstanceMethod("updateAmplitudeOptions",
+                      &QDDVis::UpdateAmplitudeOptions),
+       InstanceMethod("getAmplitudeOptions", &QDDVis::GetAmplitudeOptions),
        InstanceMethod("isReady", &QDDVis::IsReady),
        InstanceMethod("unready", &QDDVis::Unready),
        InstanceMethod("conductIrreversibleOperation",
-                      &QDDVis::ConductIrreversibleOperation)});
+                      &QDDVis::ConductIrreversibleOperation),
+       InstanceMethod("beginLoad", &QDDVis::BeginLoad),
+       InstanceMethod("pushChunk", &QDDVis::PushChunk),
+       InstanceMethod("loadAsync", &QDDVis::LoadAsync),
+       InstanceMethod("endLoadAsync", &QDDVis::EndLoadAsync),
+       InstanceMethod("toStartAsync", &QDDVis::ToStartAsync),
+       InstanceMethod("prevAsync", &QDDVis::PrevAsync),
+       InstanceMethod("nextAsync", &QDDVis::NextAsync),
+       InstanceMethod("toEndAsync", &QDDVis::ToEndAsync),
+       InstanceMethod("prepareSegmentsAsync", &QDDVis::PrepareSegmentsAsync),
+       InstanceMethod("toLineAsync", &QDDVis::ToLineAsync),
+       InstanceMethod("getDDAsync", &QDDVis::GetDDAsync),
+       InstanceMethod("getAmplitudesAsync", &QDDVis::GetAmplitudesAsync),
+       InstanceMethod("getDDDiffAsync", &QDDVis::GetDDDiffAsync),
+       InstanceMethod("getGraphAsync", &QDDVis::GetGraphAsync),
+       InstanceMethod("conductIrreversibleOperationAsync",
+                      &QDDVis::ConductIrreversibleOperationAsync),
+       InstanceMethod("saveStateAsync", &QDDVis::SaveStateAsync),
+       InstanceMethod("restoreStateAsync", &QDDVis::RestoreStateAsync)});
 
   constructor = Napi::Persistent(func);
   constructor.SuppressDestruct();
@@ -36,126 +552,22 @@ Napi::Object QDDVis::Init(Napi::Env env, Napi::Object exports) {
 }
 
 // constructor
-/**Parameterless default constructor, just initializes variables
+/**Constructor, just initializes variables
  *
- * @param info takes no parameters
+ * @param info optionally the key of the session the object belongs to (string);
+ * with a key, the engine is managed by the SessionRegistry and shared with the
+ * other objects of the session
  */
 QDDVis::QDDVis(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<QDDVis>(info) {
   Napi::Env         env = info.Env();
   Napi::HandleScope scope(env);
 
-  this->dd = std::make_unique<dd::Package<>>(1);
-  this->qc = std::make_unique<qc::QuantumComputation>();
-
-  this->iterator = this->qc->begin();
-  this->position = 0;
-}
-
-/**Applies the current operation/DD (determined by iterator) and increments both
- * iterator and position. If iterator reaches its end, atEnd will be set to
- * true.
- *
- */
-void QDDVis::stepForward() {
-  if (atEnd)
-    return; // no further steps possible
-  qc::MatrixDD currDD{};
-  if ((*iterator)->isClassicControlledOperation()) {
-    auto startIndex = static_cast<dd::Qubit>((*iterator)->getParameter().at(0));
-    auto length = static_cast<std::size_t>((*iterator)->getParameter().at(1));
-    auto expectedValue =
-        static_cast<std::size_t>((*iterator)->getParameter().at(2));
-
-    std::size_t value = 0;
-    for (std::size_t i = 0; i < length; ++i) {
-      value |= (static_cast<std::size_t>(measurements[startIndex + i]) << i);
-    }
-
-    if (value == expectedValue) {
-      currDD = dd::getDD(iterator->get(),
-                         *dd); // retrieve the "new" current operation
-    } else {
-      currDD = dd->makeIdent();
-    }
-  } else {
-    currDD =
-        dd::getDD(iterator->get(), *dd); // retrieve the "new" current operation
-  }
-
-  auto temp =
-      dd->multiply(currDD, sim); // process the current operation by multiplying
-                                 // it with the previous simulation-state
-  dd->incRef(temp);
-  dd->decRef(sim);
-  sim = temp;
-  dd->garbageCollect();
-
-  iterator++; // advance iterator
-  position++;
-  if (iterator ==
-      qc->end()) { // qc1->end() is after the last operation in the iterator
-    atEnd = true;
-  }
-}
-
-/**If either atInitial is true or the iterator is at the beginning, this method
- * does nothing. In other cases it will first decrement both position and
- * iterator before applying the inverse of the operation/DD the iterator is then
- * pointing at.
- *
- */
-void QDDVis::stepBack() {
-  if (atInitial)
-    return; // no step back possible
-
-  if (iterator == qc->begin()) {
-    atInitial = true;
-    return;
-  }
-
-  iterator--; // set iterator back to the desired operation
-  position--;
-
-  qc::MatrixDD currDD{};
-  if ((*iterator)->isClassicControlledOperation()) {
-    auto startIndex = static_cast<dd::Qubit>((*iterator)->getParameter().at(0));
-    auto length = static_cast<std::size_t>((*iterator)->getParameter().at(1));
-    auto expectedValue =
-        static_cast<std::size_t>((*iterator)->getParameter().at(2));
-
-    std::size_t value = 0;
-    for (std::size_t i = 0; i < length; ++i) {
-      value |= (static_cast<std::size_t>(measurements[startIndex + i]) << i);
-    }
-
-    if (value == expectedValue) {
-      currDD =
-          dd::getInverseDD(iterator->get(),
-                           *dd); // get the inverse of the current operation
-    } else {
-      currDD = dd->makeIdent();
-    }
-  } else {
-    currDD = dd::getInverseDD(iterator->get(),
-                              *dd); // get the inverse of the current operation
-  }
-
-  auto temp = dd->multiply(
-      currDD,
-      sim); //"remove" the current operation by multiplying with its inverse
-  dd->incRef(temp);
-  dd->decRef(sim);
-  sim = temp;
-  dd->garbageCollect();
-}
-
-void QDDVis::calculateAmplitudes(Napi::Float32Array& amplitudes) {
-  for (std::size_t i = 0; i < 1ull << qc->getNqubits(); ++i) {
-    auto result           = sim.getValueByIndex(i);
-    amplitudes[2 * i]     = static_cast<float>(result.real());
-    amplitudes[2 * i + 1] = static_cast<float>(result.imag());
-  }
+  if (info.Length() > 0 && info[0].IsString())
+    this->engine = SessionRegistry::instance().simulation(
+        info[0].As<Napi::String>().Utf8Value());
+  else
+    this->engine = std::make_shared<SimulationEngine>();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -170,130 +582,110 @@ void QDDVis::calculateAmplitudes(Napi::Float32Array& amplitudes) {
  */
 Napi::Value QDDVis::Load(const Napi::CallbackInfo& info) {
   Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
+  Napi::Object state = loadState(env, {});
   state.Set("numOfOperations", Napi::Number::New(env, -1));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-  state.Set("noGoingBack", Napi::Boolean::New(env, false));
 
-  // check if the correct parameters have been passed
-  if (info.Length() < 4) {
-    Napi::RangeError::New(
-        env, "Need 4 (String, unsigned int, unsigned int, bool) arguments!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsString()) { // algorithm
-    Napi::TypeError::New(env, "arg1: String expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[1].IsNumber()) { // format code (1 = QASM, 2 = Real)
-    Napi::TypeError::New(env, "arg3: unsigned int expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[2].IsNumber()) { // number of operations to immediately process
-    Napi::TypeError::New(env, "arg2: unsigned int expected!")
-        .ThrowAsJavaScriptException();
+  auto args = parseLoadArguments(info);
+  if (!args.has_value())
     return state;
-  }
-  if (!info[3].IsBoolean()) { // whether operations should be processed while
-                              // advancing the iterator to opNum or not (true =
-                              // new simulation; false = continue simulation)
-    Napi::TypeError::New(env, "arg3: boolean expected!")
-        .ThrowAsJavaScriptException();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
     return state;
-  }
-
-  // the first parameter (algorithm)
-  auto              arg  = info[0].As<Napi::String>();
-  const std::string algo = arg.Utf8Value();
-  std::stringstream ss{algo};
 
   try {
-    // second parameter describes the format of the algorithm
-    const auto formatCode =
-        static_cast<unsigned int>(info[1].As<Napi::Number>());
-    if (formatCode == 1)
-      qc->import(ss, qc::Format::OpenQASM3);
-    else if (formatCode == 2)
-      qc->import(ss, qc::Format::Real);
-    else {
-      Napi::Error::New(env, "Invalid format-code!")
-          .ThrowAsJavaScriptException();
-      return state;
-    }
-
+    return loadState(env, engine->load(std::move(args->algo), args->formatCode,
+                                       args->opNum, args->process));
   } catch (const std::exception& e) {
-    const auto* msg = e.what();
-    std::cout << "Exception while loading the algorithm: " << msg << "\n";
-    Napi::Error::New(env, std::string(msg)).ThrowAsJavaScriptException();
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return state;
   }
+}
 
-  // re-initialize some variables (though depending on opNum they might change
-  // in the next lines)
-  ready     = true;
-  atInitial = true;
-  atEnd     = false;
-  iterator  = qc->begin();
-  position  = 0;
-  // resize the DD package so that it can hold as many variables
-  dd->resize(qc->getNqubits());
-  measurements.resize(qc->getNqubits());
+/**Same as load, but imports and processes the algorithm on a worker thread.
+ *
+ * @return a Promise resolving to the same object load returns
+ */
+Napi::Value QDDVis::LoadAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto args = parseLoadArguments(info);
+  if (!args.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::LoadResult>::Queue(
+      Value(),
+      [engine, args = *args]() mutable {
+        const auto lock = engine->lock();
+        return engine->load(std::move(args.algo), args.formatCode, args.opNum,
+                            args.process);
+      },
+      loadState);
+}
 
-  state.Set("numOfOperations",
-            Napi::Number::New(env, static_cast<double>(qc->getNops())));
-
-  // the third parameter (how many operations to apply immediately)
-  auto opNum = static_cast<unsigned int>(
-      info[2].As<Napi::Number>()); // at this point opNum may be bigger than the
-                                   // number of operations the algorithm has!
-  if (opNum > qc->getNops())
-    opNum = static_cast<unsigned int>(qc->getNops());
-  if (opNum > 0) {
-    atInitial          = false;
-    const bool process = static_cast<bool>(
-        info[3].As<Napi::Boolean>()); // the fourth parameter tells us to
-                                      // process iterated operations or not
-    if (process) {
-      if (sim.p != nullptr) {
-        dd->decRef(sim);
-      }
-      sim = dd->makeZeroState(qc->getNqubits());
-      dd->incRef(sim);
-
-      for (unsigned int i = 0; i < opNum; i++) { // apply some operations
-        stepForward();
-      }
-    } else {
-      for (unsigned int i = 0; i < opNum; i++) {
-        iterator++; // just advance the iterator so it points to the operations
-                    // where we stopped before the edit
-        position++;
-      }
-    }
-    if (iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
-                                  (*iterator)->getType() == qc::Reset)) {
-      state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-    }
-    if (iterator != qc->begin()) {
-      auto testForMeasureIt = iterator;
-      --testForMeasureIt;
-      if ((*testForMeasureIt)->getType() == qc::Measure ||
-          (*testForMeasureIt)->getType() == qc::Reset) {
-        state.Set("noGoingBack", Napi::Boolean::New(env, true));
-      }
-    }
+/**Starts streaming an algorithm in chunks (see pushChunk and endLoadAsync), so
+ * large algorithms never have to exist as a single JavaScript string. A
+ * previously started stream is discarded.
+ *
+ * @param info has no parameters
+ */
+void QDDVis::BeginLoad([[maybe_unused]] const Napi::CallbackInfo& info) {
+  streamedAlgorithm = std::string{};
+  streaming         = true;
+  engine->setStreamedBytes(0);
+}
 
-  } else { // sim needs to be initialized in some cases
-    if (sim.p != nullptr) {
-      dd->decRef(sim);
-    }
-    sim = dd->makeZeroState(qc->getNqubits());
-    dd->incRef(sim);
+/**Appends the next chunk of the streamed algorithm.
+ *
+ * @param info has one parameter: the chunk (Buffer with UTF-8 text or String)
+ */
+void QDDVis::PushChunk(const Napi::CallbackInfo& info) {
+  if (!streaming) {
+    Napi::Error::New(info.Env(), "No algorithm is being streamed!")
+        .ThrowAsJavaScriptException();
+    return;
   }
-  return state;
+  // a single algorithm may take up the whole memory budget of the sessions;
+  // the next access of the session evicts others if the budget is exceeded
+  const auto maxSize = SessionRegistry::instance().getMemoryBudget();
+  if (!appendChunk(info, streamedAlgorithm, maxSize)) {
+    streamedAlgorithm = std::string{};
+    streaming         = false;
+  }
+  engine->setStreamedBytes(streamedAlgorithm.capacity());
+}
+
+/**Finishes streaming the algorithm and imports and processes it on a worker
+ * thread, just like loadAsync.
+ *
+ * @param info same as for load, but without the algorithm
+ * @return a Promise resolving to the same object load returns
+ */
+Napi::Value QDDVis::EndLoadAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (!streaming) {
+    Napi::Error::New(env, "No algorithm is being streamed!")
+        .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  auto args = parseLoadArguments(info, false);
+  if (!args.has_value())
+    return env.Undefined();
+  // the text is moved into the engine, which keeps it as the loaded algorithm
+  args->algo        = std::move(streamedAlgorithm);
+  streamedAlgorithm = std::string{};
+  streaming         = false;
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::LoadResult>::Queue(
+      Value(),
+      [engine, args = std::move(*args)]() mutable {
+        const auto lock = engine->lock();
+        // from now on, the text is counted as the algorithm of the engine
+        engine->setStreamedBytes(0);
+        return engine->load(std::move(args.algo), args.formatCode, args.opNum,
+                            args.process);
+      },
+      loadState);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -306,38 +698,35 @@ Napi::Value QDDVis::Load(const Napi::CallbackInfo& info) {
  * occurred)
  */
 Napi::Value QDDVis::ToStart(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  if (!ready) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
     return Napi::Boolean::New(env, false);
-  } else if (qc->empty()) {
+
+  try {
+    return Napi::Boolean::New(env, engine->toStart());
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return Napi::Boolean::New(env, false);
   }
+}
 
-  if (atInitial)
-    return Napi::Boolean::New(env, false); // nothing changed
-  else {
-    try {
-      dd->decRef(sim);
-      sim = dd->makeZeroState(qc->getNqubits());
-      dd->incRef(sim);
-      atInitial = true;
-      atEnd = false; // now we are definitely not at the end (if there were no
-                     // operation, so atInitial and atEnd could be true at the
-                     // same time, if(qc1-empty)
-      // would already have returned
-      iterator = qc->begin();
-      position = 0;
-      std::fill(measurements.begin(), measurements.end(), false);
-
-      return Napi::Boolean::New(env, true); // something changed
-
-    } catch (const std::exception& e) {
-      std::cout << "Exception while going back to the start!" << std::endl;
-      std::cout << e.what() << std::endl;
-      return Napi::Boolean::New(env, false); // nothing changed
-    }
-  }
+/**Same as toStart, but goes back on a worker thread.
+ *
+ * @return a Promise resolving to the boolean toStart returns
+ */
+Napi::Value
+QDDVis::ToStartAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<bool>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->toStart();
+      },
+      [](Napi::Env env, const bool& changed) {
+        return Napi::Boolean::New(env, changed);
+      });
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -353,45 +742,31 @@ Napi::Value QDDVis::ToStart(const Napi::CallbackInfo& info) {
  * operation now is an irreversible operation
  */
 Napi::Value QDDVis::Prev(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("noGoingBack", Napi::Boolean::New(env, false));
-
-  if (!ready) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
-    return state;
-  } else if (qc->empty()) {
-    return state;
-  }
-
-  if (atEnd) {
-    atEnd = false;
-  } else if (atInitial) {
-    return state; // we can't go any further back
-  }
-
-  try {
-    stepBack(); // go back to the start before the last processed operation
-    state.Set("changed", Napi::Boolean::New(env, true));
-
-    if (iterator != qc->begin()) {
-      auto testForMeasureIt = iterator;
-      --testForMeasureIt;
-      if ((*testForMeasureIt)->getType() == qc::Measure ||
-          (*testForMeasureIt)->getType() == qc::Reset) {
-        state.Set("noGoingBack", Napi::Boolean::New(env, true));
-      }
+  Napi::Env                    env = info.Env();
+  SimulationEngine::PrevResult result{};
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock()) {
+    try {
+      result = engine->prev();
+    } catch (const std::exception& e) {
+      Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     }
-
-    return state; // something changed
-
-  } catch (const std::exception& e) {
-    std::cout << "Exception while getting the current operation {src: prev}!"
-              << std::endl;
-    std::cout << e.what() << std::endl;
-    return state;
   }
+  return prevState(env, result);
+}
+
+/**Same as prev, but goes back on a worker thread.
+ *
+ * @return a Promise resolving to the same object prev returns
+ */
+Napi::Value QDDVis::PrevAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::PrevResult>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->prev();
+      },
+      prevState);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -408,96 +783,31 @@ Napi::Value QDDVis::Prev(const Napi::CallbackInfo& info) {
  * measurement/reset parameters
  */
 Napi::Value QDDVis::Next(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("conductIrreversibleOperation", Napi::Boolean::New(env, false));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-
-  if (!ready) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
-    return state;
-  } else if (qc->empty()) {
-    return state;
-  }
-
-  if (atInitial) {
-    atInitial = false;
-  } else if (atEnd) {
-    return state; // we can't go any further ahead
-  }
-
-  try {
-    state.Set("changed", Napi::Boolean::New(env, true));
-
-    if ((*iterator)->getType() == qc::Reset) {
-      auto qubits        = (*iterator)->getTargets();
-      auto totalResets   = qubits.size();
-      auto qubitToReset  = qubits.front();
-      auto qubitsReset   = 0;
-      auto [pzero, pone] = dd->determineMeasurementProbabilities(
-          sim, static_cast<dd::Qubit>(qubitToReset), true);
-
-      Napi::Object reset = Napi::Object::New(env);
-      reset.Set("qubit", Napi::Number::New(env, qubitToReset));
-      reset.Set("pzero", Napi::Number::New(env, pzero));
-      reset.Set("pone", Napi::Number::New(env, pone));
-      reset.Set("count", Napi::Number::New(env, qubitsReset));
-      reset.Set("total",
-                Napi::Number::New(env, static_cast<double>(totalResets)));
-      state.Set("parameter", reset);
-      state.Set("conductIrreversibleOperation", Napi::Boolean::New(env, true));
-
-      iterator++; // advance iterator
-      position++;
-      if (iterator ==
-          qc->end()) { // qc1->end() is after the last operation in the iterator
-        atEnd = true;
-      }
-    } else if ((*iterator)->getType() == qc::Measure) {
-      auto qubits = (*iterator)->getTargets();
-      auto cbits  = dynamic_cast<qc::NonUnitaryOperation*>(iterator->get())
-                       ->getClassics();
-      auto totalMeasurements = qubits.size();
-      auto qubitToMeasure    = qubits.front();
-      auto cbitToStore       = cbits.front();
-      auto qubitsMeasured    = 0;
-      auto [pzero, pone]     = dd->determineMeasurementProbabilities(
-          sim, static_cast<dd::Qubit>(qubitToMeasure), true);
-
-      Napi::Object measurement = Napi::Object::New(env);
-      measurement.Set("qubit", Napi::Number::New(env, qubitToMeasure));
-      measurement.Set("pzero", Napi::Number::New(env, pzero));
-      measurement.Set("pone", Napi::Number::New(env, pone));
-      measurement.Set("cbit",
-                      Napi::Number::New(env, static_cast<double>(cbitToStore)));
-      measurement.Set("count", Napi::Number::New(env, qubitsMeasured));
-      measurement.Set("total", Napi::Number::New(env, static_cast<double>(
-                                                          totalMeasurements)));
-      state.Set("parameter", measurement);
-      state.Set("conductIrreversibleOperation", Napi::Boolean::New(env, true));
-
-      iterator++; // advance iterator
-      position++;
-      if (iterator ==
-          qc->end()) { // qc1->end() is after the last operation in the iterator
-        atEnd = true;
-      }
-    } else {
-      stepForward(); // process the next operation
-    }
-
-    if (iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
-                                  (*iterator)->getType() == qc::Reset)) {
-      state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
+  Napi::Env                    env = info.Env();
+  SimulationEngine::NextResult result{};
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock()) {
+    try {
+      result = engine->next();
+    } catch (const std::exception& e) {
+      Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     }
-    return state;
-  } catch (const std::exception& e) {
-    std::cout << "Exception while getting the current operation {src: next}!"
-              << std::endl;
-    std::cout << e.what() << std::endl;
-    return state;
   }
+  return nextState(env, result);
+}
+
+/**Same as next, but applies the operation on a worker thread.
+ *
+ * @return a Promise resolving to the same object next returns
+ */
+Napi::Value QDDVis::NextAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::NextResult>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->next();
+      },
+      nextState);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -513,52 +823,33 @@ Napi::Value QDDVis::Next(const Napi::CallbackInfo& info) {
  * encountered
  */
 Napi::Value QDDVis::ToEnd(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-  state.Set("barrier", Napi::Boolean::New(env, false));
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return toEndState(env, {});
 
-  if (!ready) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
-    return state;
-  } else if (qc->empty()) {
-    return state;
+  try {
+    return toEndState(env, engine->toEnd());
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return toEndState(env, {});
   }
+}
 
-  if (atEnd)
-    return state; // nothing changed
-  else {
-    atInitial = false; // now we are definitely not at the beginning (if there
-                       // were no operation, so atInitial and atEnd could be
-                       // true at the same time, if(qc1-empty)
-    // would already have returned
-    try {
-      state.Set("changed", Napi::Boolean::New(env, true));
-      unsigned long long nops = 0;
-      while (!atEnd) {
-        if ((*iterator)->getType() == qc::Measure ||
-            (*iterator)->getType() == qc::Reset) {
-          state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-          break;
-        } else if ((*iterator)->getType() == qc::Barrier) {
-          ++nops;
-          stepForward(); // process the barrier
-          state.Set("barrier", Napi::Boolean::New(env, true));
-          break;
-        } else {
-          ++nops;
-          stepForward(); // process the next operation
-        }
-      }
-      state.Set("nops", Napi::Number::New(env, static_cast<double>(nops)));
-      return state;
-    } catch (const std::exception& e) {
-      std::cout << "Exception while going to the end!" << std::endl;
-      std::cout << e.what() << std::endl;
-      return state;
-    }
-  }
+/**Same as toEnd, but processes the operations on a worker thread.
+ *
+ * @return a Promise resolving to the same object toEnd returns
+ */
+Napi::Value
+QDDVis::ToEndAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::ToEndResult>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->toEnd();
+      },
+      toEndState);
 }
 
 /**Depending on the current position of the iterator and the given parameter
@@ -574,163 +865,288 @@ Napi::Value QDDVis::ToEnd(const Napi::CallbackInfo& info) {
 Napi::Value QDDVis::ToLine(const Napi::CallbackInfo& info) {
   Napi::Env         env = info.Env();
   Napi::HandleScope scope(env);
-  Napi::Object      state = Napi::Object::New(env);
-  state.Set("changed", Napi::Boolean::New(env, false));
-  state.Set("noGoingBack", Napi::Boolean::New(env, false));
-  state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-  state.Set("reset", Napi::Boolean::New(env, false));
-
-  // check if the correct parameters have been passed
-  if (info.Length() < 1) {
-    Napi::RangeError::New(env, "Need 1 (unsigned int) argument!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
-  if (!info[0].IsNumber()) { // line number/position
-    Napi::TypeError::New(env, "arg1: unsigned int expected!")
-        .ThrowAsJavaScriptException();
-    return state;
-  }
 
-  auto param = static_cast<unsigned int>(info[0].As<Napi::Number>());
-  if (param > qc->getNops())
-    // we can't go further than to the end
-    param = static_cast<unsigned int>(qc->getNops());
-  const unsigned int targetPos = param;
+  const auto targetPos = parseLineArgument(info);
+  if (!targetPos.has_value())
+    return toLineState(env, {});
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return toLineState(env, {});
 
   try {
-    if (iterator != qc->begin()) {
-      auto testForMeasureIt = iterator;
-      --testForMeasureIt;
-      if ((*testForMeasureIt)->getType() == qc::Measure ||
-          (*testForMeasureIt)->getType() == qc::Reset) {
-        state.Set("noGoingBack", Napi::Boolean::New(env, true));
-      }
-    }
-    if (iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
-                                  (*iterator)->getType() == qc::Reset)) {
-      state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-    }
-    if (position == targetPos)
-      return state; // nothing changed
-
-    unsigned long long nops = 0;
-    if (targetPos < position) {
-      unsigned int distanceFromPosition = position - targetPos;
-      // if target position is closer to start as to current position
-      // computation can be restarted
-      if (targetPos < distanceFromPosition) {
-        state.Set("reset", Napi::Boolean::New(env, true));
-        state.Set("changed", Napi::Boolean::New(env, true));
-        state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-        state.Set("noGoingBack", Napi::Boolean::New(env, true));
-
-        dd->decRef(sim);
-        sim = dd->makeZeroState(qc->getNqubits());
-        dd->incRef(sim);
-        atInitial = true;
-        atEnd     = false;
-        iterator  = qc->begin();
-        position  = 0;
-        std::fill(measurements.begin(), measurements.end(), false);
-        if ((*iterator)->getType() == qc::Measure ||
-            (*iterator)->getType() == qc::Reset) {
-          state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-        }
-      } else {
-        state.Set("noGoingBack", Napi::Boolean::New(env, false));
-        while (position > targetPos) {
-          auto testForMeasureIt = iterator;
-          --testForMeasureIt;
-          if ((*testForMeasureIt)->getType() == qc::Measure ||
-              (*testForMeasureIt)->getType() == qc::Reset) {
-            state.Set("noGoingBack", Napi::Boolean::New(env, true));
-            break;
-          }
-          ++nops;
-          stepBack();
-          state.Set("changed", Napi::Boolean::New(env, true));
-          state.Set("nextIsIrreversible", Napi::Boolean::New(env, false));
-        }
-      }
-    }
-
-    while (position < targetPos) {
-      if ((*iterator)->getType() == qc::Measure ||
-          (*iterator)->getType() == qc::Reset) {
-        state.Set("nextIsIrreversible", Napi::Boolean::New(env, true));
-        break;
-      } else {
-        ++nops;
-        stepForward(); // process the next operation
-      }
-      state.Set("changed", Napi::Boolean::New(env, true));
-      state.Set("noGoingBack", Napi::Boolean::New(env, false));
-    }
-    state.Set("nops", Napi::Number::New(env, static_cast<double>(nops)));
-
-    atInitial = false;
-    atEnd     = false;
-    if (position == 0)
-      atInitial = true;
-    else if (position == qc->getNops())
-      atEnd = true;
-
-    return state; // something changed
-
+    return toLineState(env, engine->toLine(*targetPos));
   } catch (const std::exception& e) {
-    std::stringstream ss{};
-    ss << "Exception while going from " << position << " to " << targetPos
-       << ": " << e.what() << "\n";
-    const auto msg = ss.str();
-    std::cout << msg << std::endl;
-    Napi::Error::New(env, msg).ThrowAsJavaScriptException();
-    return state;
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return toLineState(env, {});
   }
 }
 
+/**Same as toLine, but processes the operations on a worker thread.
+ *
+ * @return a Promise resolving to the same object toLine returns
+ */
+Napi::Value QDDVis::ToLineAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env       = info.Env();
+  const auto targetPos = parseLineArgument(info);
+  if (!targetPos.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::ToLineResult>::Queue(
+      Value(),
+      [engine, targetPos = *targetPos]() {
+        const auto lock = engine->lock();
+        return engine->toLine(targetPos);
+      },
+      toLineState);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /**Creates a DD in the .dot-format for the current state of the simulation.
  *
- * @param info has no parameters
+ * @param info optionally takes an amplitude mode ("dense", "sparse" or "topk")
+ * and limit that override the ones set by updateAmplitudeOptions for this call
  * @return a string describing the current state of the simulation as DD in the
  * .dot-format
  */
 Napi::Value QDDVis::GetDD(const Napi::CallbackInfo& info) {
-  Napi::Env    env   = info.Env();
-  Napi::Object state = Napi::Object::New(env);
-  if (!ready) {
-    Napi::Error::New(env, "No algorithm loaded!").ThrowAsJavaScriptException();
+  Napi::Env                                         env = info.Env();
+  std::optional<SimulationEngine::AmplitudeOptions> options{};
+  if (!parseExportArguments(info, options))
+    return Napi::String::New(env, "-1");
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return Napi::String::New(env, "-1");
+
+  try {
+    auto result =
+        options.has_value() ? engine->getDD(*options) : engine->getDD();
+    return ddState(env, result);
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     return Napi::String::New(env, "-1");
   }
+}
+
+/**Same as getDD, but exports the DD on a worker thread.
+ *
+ * @return a Promise resolving to the same object getDD returns
+ */
+Napi::Value QDDVis::GetDDAsync(const Napi::CallbackInfo& info) {
+  std::optional<SimulationEngine::AmplitudeOptions> options{};
+  if (!parseExportArguments(info, options))
+    return info.Env().Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::ExportResult>::Queue(
+      Value(),
+      [engine, options]() {
+        const auto lock = engine->lock();
+        return options.has_value() ? engine->getDD(*options) : engine->getDD();
+      },
+      ddState);
+}
+
+/**Same as getDDAsync, but only exports the amplitudes, i.e., the .dot-format of
+ * the DD is not created.
+ *
+ * @return a Promise resolving to an object with nqubits, amplitudes and (for
+ * sparse and top-k exports) indices
+ */
+Napi::Value QDDVis::GetAmplitudesAsync(const Napi::CallbackInfo& info) {
+  std::optional<SimulationEngine::AmplitudeOptions> options{};
+  if (!parseExportArguments(info, options))
+    return info.Env().Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::ExportResult>::Queue(
+      Value(),
+      [engine, options]() {
+        const auto lock = engine->lock();
+        return options.has_value() ? engine->getAmplitudes(*options)
+                                   : engine->getAmplitudes();
+      },
+      amplitudeState);
+}
+
+/**Determines how the DD of the current state differs from the one returned by
+ * the previous call (see SimulationEngine::getDDDiff).
+ *
+ * @param info optionally takes a boolean (reset): whether the complete DD
+ * should be reported
+ * @return an object with the root edge and the added, changed and removed
+ * nodes
+ */
+Napi::Value QDDVis::GetDDDiff(const Napi::CallbackInfo& info) {
+  Napi::Env  env   = info.Env();
+  const auto reset = parseResetArgument(info);
+  if (!reset.has_value())
+    return env.Undefined();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return env.Undefined();
 
-  std::stringstream ss{};
   try {
-    dd::toDot(sim, ss, this->showColors, this->showEdgeLabels,
-              this->showClassic, false, this->usePolarCoordinates);
-    std::string str = ss.str();
-    state.Set("dot", Napi::String::New(env, str));
-    state.Set("amplitudes", Napi::Float32Array::New(env, 0));
-    if (qc->getNqubits() <= MAX_QUBITS_FOR_AMPLITUDES) {
-      auto amplitudes =
-          Napi::Float32Array::New(env, 1ull << (qc->getNqubits() + 1));
-      calculateAmplitudes(amplitudes);
-      state.Set("amplitudes", amplitudes);
-    }
-    return state;
+    return graphDiffState(env, engine->getDDDiff(*reset));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+}
+
+/**Same as getDDDiff, but determines the difference on a worker thread.
+ *
+ * @return a Promise resolving to the same object getDDDiff returns
+ */
+Napi::Value QDDVis::GetDDDiffAsync(const Napi::CallbackInfo& info) {
+  const auto reset = parseResetArgument(info);
+  if (!reset.has_value())
+    return info.Env().Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::GraphDiff>::Queue(
+      Value(),
+      [engine, reset = *reset]() {
+        const auto lock = engine->lock();
+        return engine->getDDDiff(reset);
+      },
+      graphDiffState);
+}
+
+/**Exports the DD of the current state as typed node and edge tables instead of
+ * DOT text, honouring the export options.
+ *
+ * @param info has no parameters
+ * @return an object with the typed arrays nodeIds, nodeQubits, edgeSources,
+ * edgeTargets, edgeIndices and edgeWeights and the boolean polar
+ */
+Napi::Value QDDVis::GetGraph(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return env.Undefined();
 
+  try {
+    auto tables = engine->getGraph();
+    return graphState(env, tables);
   } catch (const std::exception& e) {
-    std::stringstream sserr{};
-    sserr << "Exception while getting the DD: " << e.what() << "\n";
-    sserr << "The values of the Flags are: " << this->showColors << ", "
-          << this->showEdgeLabels << ", " << this->showClassic << ", "
-          << this->usePolarCoordinates << "\n";
-    const auto err = sserr.str();
-    Napi::Error::New(env, err).ThrowAsJavaScriptException();
-    return Napi::String::New(env, "-1");
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return env.Undefined();
   }
 }
 
+/**Same as getGraph, but exports the DD on a worker thread.
+ *
+ * @return a Promise resolving to the same object getGraph returns
+ */
+Napi::Value
+QDDVis::GetGraphAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<GraphTables>::Queue(
+      Value(),
+      [engine]() {
+        const auto lock = engine->lock();
+        return engine->getGraph();
+      },
+      graphState);
+}
+
+/**Saves the current simulation (algorithm, position, measurement results,
+ * export options and state) to a binary file on a worker thread.
+ *
+ * @param info has a string argument (path of the file)
+ * @return a Promise resolving to true once the file is written
+ */
+Napi::Value QDDVis::SaveStateAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto path = parsePathArgument(info);
+  if (!path.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<bool>::Queue(
+      Value(),
+      [engine, path = *path]() {
+        const auto lock = engine->lock();
+        sessionfile::save(path,
+                          [engine](std::ostream& os) { engine->save(os); });
+        return true;
+      },
+      [](Napi::Env env, const bool& saved) {
+        return Napi::Boolean::New(env, saved);
+      });
+}
+
+/**Replaces the current simulation with one saved by saveStateAsync on a worker
+ * thread. The state is read from the file instead of being simulated again.
+ *
+ * @param info has a string argument (path of the file)
+ * @return a Promise resolving to the same object load returns, extended by the
+ * restored algorithm, its format code and the restored position
+ */
+Napi::Value QDDVis::RestoreStateAsync(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto path = parsePathArgument(info);
+  if (!path.has_value())
+    return env.Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::RestoreResult>::Queue(
+      Value(),
+      [engine, path = *path]() {
+        auto       ifs  = sessionfile::open(path);
+        const auto lock = engine->lock();
+        return engine->restore(ifs);
+      },
+      restoreState);
+}
+
+/**Sets which amplitudes are exported by getDD/getDDAsync.
+ *
+ * @param info has a string argument (mode: "dense", "sparse" or "topk") and an
+ * optional unsigned int argument (limit: maximum number of qubits for dense
+ * exports, maximum number of amplitudes otherwise)
+ */
+void QDDVis::UpdateAmplitudeOptions(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() < 1) {
+    Napi::RangeError::New(env, "Need 1 (String) or 2 (String, unsigned int) "
+                               "arguments!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  const auto options = parseAmplitudeOptions(env, info[0], info[1]);
+  if (!options.has_value())
+    return;
+
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->updateAmplitudeOptions(*options);
+}
+
+Napi::Value QDDVis::GetAmplitudeOptions(const Napi::CallbackInfo& info) {
+  Napi::Env    env   = info.Env();
+  Napi::Object state = Napi::Object::New(env);
+
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return state;
+  const auto& options = engine->getAmplitudeOptions();
+  switch (options.mode) {
+  case SimulationEngine::AmplitudeMode::Dense:
+    state.Set("mode", "dense");
+    break;
+  case SimulationEngine::AmplitudeMode::Sparse:
+    state.Set("mode", "sparse");
+    break;
+  case SimulationEngine::AmplitudeMode::TopK:
+    state.Set("mode", "topk");
+    break;
+  }
+  state.Set("limit", static_cast<double>(options.limit));
+  return state;
+}
+
 /**Updates the three fields of this object that determine with which options the
  * DD should be exported (on the next GetDD-call).
  *
@@ -765,20 +1181,49 @@ void QDDVis::UpdateExportOptions(const Napi::CallbackInfo& info) {
     return;
   }
 
-  this->showColors          = static_cast<bool>(info[0].As<Napi::Boolean>());
-  this->showEdgeLabels      = static_cast<bool>(info[1].As<Napi::Boolean>());
-  this->showClassic         = static_cast<bool>(info[2].As<Napi::Boolean>());
-  this->usePolarCoordinates = static_cast<bool>(info[3].As<Napi::Boolean>());
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return;
+  engine->updateExportOptions(static_cast<bool>(info[0].As<Napi::Boolean>()),
+                              static_cast<bool>(info[1].As<Napi::Boolean>()),
+                              static_cast<bool>(info[2].As<Napi::Boolean>()),
+                              static_cast<bool>(info[3].As<Napi::Boolean>()));
+}
+
+/**Enables or disables gate fusion, i.e., whether toEnd, toLine and load apply
+ * runs of small adjacent operations as one pre-multiplied DD.
+ *
+ * @param info has one boolean argument (enabled)
+ */
+void QDDVis::SetGateFusion(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() != 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  if (!info[0].IsBoolean()) { // enabled
+    Napi::TypeError::New(env, "arg1: Boolean expected!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->setGateFusion(static_cast<bool>(info[0].As<Napi::Boolean>()));
 }
 
 Napi::Value QDDVis::GetExportOptions(const Napi::CallbackInfo& info) {
   Napi::Env    env   = info.Env();
   Napi::Object state = Napi::Object::New(env);
 
-  state.Set("colored", this->showColors);
-  state.Set("edgeLabels", this->showEdgeLabels);
-  state.Set("classic", this->showClassic);
-  state.Set("polar", this->usePolarCoordinates);
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return state;
+  state.Set("colored", engine->getShowColors());
+  state.Set("edgeLabels", engine->getShowEdgeLabels());
+  state.Set("classic", engine->getShowClassic());
+  state.Set("polar", engine->getUsePolarCoordinates());
   return state;
 }
 
@@ -789,148 +1234,147 @@ Napi::Value QDDVis::GetExportOptions(const Napi::CallbackInfo& info) {
  * successfully loaded)
  */
 Napi::Value QDDVis::IsReady(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  return Napi::Boolean::New(env, this->ready);
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return Napi::Boolean::New(env, false);
+  return Napi::Boolean::New(env, engine->isReady());
 }
 
-void QDDVis::Unready([[maybe_unused]] const Napi::CallbackInfo& info) {
-  this->ready = false;
+void QDDVis::Unready(const Napi::CallbackInfo& info) {
+  if (const auto lock = tryLockEngine(info.Env(), *engine); lock.owns_lock())
+    engine->unready();
 }
 
 Napi::Value
 QDDVis::ConductIrreversibleOperation(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
+  Napi::Env  env  = info.Env();
+  const auto args = parseConductArguments(info);
+  if (!args.has_value())
+    return conductState(env, {});
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return conductState(env, {});
 
-  if (info.Length() < 1) {
-    Napi::RangeError::New(
-        env,
-        "Need 1 Object(int, double, double, string, int, int, (int)) argument!")
-        .ThrowAsJavaScriptException();
-  }
-  if (!info[0].IsObject()) {
-    Napi::TypeError::New(
-        env,
-        "Need 1 Object(int, double, double, string, int, int, (int)) argument!")
-        .ThrowAsJavaScriptException();
-  }
-  const auto obj = info[0].ToObject();
-  if (!obj.Has("qubit")) {
-    Napi::TypeError::New(env, "Expected qubit").ThrowAsJavaScriptException();
-  } else if (!obj.Get("qubit").IsNumber()) {
-    Napi::TypeError::New(env, "qubit: Number expected!")
-        .ThrowAsJavaScriptException();
+  try {
+    return conductState(env, engine->conductIrreversibleOperation(
+                                 args->qubit, args->pzero, args->pone,
+                                 args->classicalValueToMeasure, args->count,
+                                 args->total, args->cbit));
+  } catch (const std::exception& e) {
+    Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    return conductState(env, {});
   }
+}
 
-  if (!obj.Has("pzero")) {
-    Napi::TypeError::New(env, "Expected probability for 0")
-        .ThrowAsJavaScriptException();
-  } else if (!obj.Get("pzero").IsNumber()) {
-    Napi::TypeError::New(env, "pzero: Number expected!")
-        .ThrowAsJavaScriptException();
-  }
+/**Same as conductIrreversibleOperation, but conducts the operation on a worker
+ * thread.
+ *
+ * @return a Promise resolving to the same object conductIrreversibleOperation
+ * returns
+ */
+Napi::Value
+QDDVis::ConductIrreversibleOperationAsync(const Napi::CallbackInfo& info) {
+  const auto args = parseConductArguments(info);
+  if (!args.has_value())
+    return info.Env().Undefined();
+
+  auto* engine = this->engine.get();
+  return AsyncTask<SimulationEngine::ConductResult>::Queue(
+      Value(),
+      [engine, args = *args]() {
+        const auto lock = engine->lock();
+        return engine->conductIrreversibleOperation(
+            args.qubit, args.pzero, args.pone, args.classicalValueToMeasure,
+            args.count, args.total, args.cbit);
+      },
+      conductState);
+}
 
-  if (!obj.Has("pone")) {
-    Napi::TypeError::New(env, "Expected probability for 1")
-        .ThrowAsJavaScriptException();
-  } else if (!obj.Get("pone").IsNumber()) {
-    Napi::TypeError::New(env, "pone: Number expected!")
+/**Enables or disables applying the functionality DDs of whole measurement-free
+ * segments in multi-step moves. The DDs are built by prepareSegmentsAsync.
+ *
+ * @param info has one boolean argument (enabled)
+ */
+void QDDVis::SetSegmentMatrices(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() != 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
         .ThrowAsJavaScriptException();
+    return;
   }
-
-  if (!obj.Has("classicalValueToMeasure")) {
-    Napi::TypeError::New(env, "Expected desired outcome")
-        .ThrowAsJavaScriptException();
-  } else if (!obj.Get("classicalValueToMeasure").IsString()) {
-    Napi::TypeError::New(env, "classicalValueToMeasure: String expected!")
+  if (!info[0].IsBoolean()) { // enabled
+    Napi::TypeError::New(env, "arg1: Boolean expected!")
         .ThrowAsJavaScriptException();
+    return;
   }
 
-  if (!obj.Has("count")) {
-    Napi::TypeError::New(env, "Expected qubits already measured")
-        .ThrowAsJavaScriptException();
-  } else if (!obj.Get("count").IsNumber()) {
-    Napi::TypeError::New(env, "count: Number expected!")
-        .ThrowAsJavaScriptException();
-  }
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->setSegmentMatrices(static_cast<bool>(info[0].As<Napi::Boolean>()));
+}
 
-  if (!obj.Has("total")) {
-    Napi::TypeError::New(env, "Expected total qubits to measure")
-        .ThrowAsJavaScriptException();
-  } else if (!obj.Get("total").IsNumber()) {
-    Napi::TypeError::New(env, "total: Number expected!")
+/**Enables or disables recording the duration of building the DD of every
+ * applied operation, of the multiplication and of the garbage collection as
+ * well as the size of the resulting DD and the hit ratio of the compute table.
+ * Enabling discards the statistics recorded so far.
+ *
+ * @param info has one boolean argument (enabled)
+ */
+void QDDVis::SetProfiling(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  // check if the correct parameters have been passed
+  if (info.Length() != 1) {
+    Napi::RangeError::New(env, "Need 1 (bool) argument!")
         .ThrowAsJavaScriptException();
+    return;
   }
-
-  auto qubit =
-      static_cast<dd::Qubit>(obj.Get("qubit").As<Napi::Number>().Int64Value());
-  auto pzero = obj.Get("pzero").As<Napi::Number>().DoubleValue();
-  auto pone  = obj.Get("pone").As<Napi::Number>().DoubleValue();
-  auto classicalValueToMeasure =
-      obj.Get("classicalValueToMeasure").As<Napi::String>().Utf8Value();
-  auto count = obj.Get("count").As<Napi::Number>().Int64Value();
-  auto total = obj.Get("total").As<Napi::Number>().Int64Value();
-
-  bool isReset = false;
-  if (!obj.Has("cbit")) {
-    isReset = true;
-  } else if (!obj.Get("cbit").IsNumber()) {
-    Napi::TypeError::New(env, "cbit: Number expected!")
+  if (!info[0].IsBoolean()) { // enabled
+    Napi::TypeError::New(env, "arg1: Boolean expected!")
         .ThrowAsJavaScriptException();
+    return;
   }
 
-  // return value
-  Napi::Object state = Napi::Object::New(env);
-  state.Set("finished", Napi::Boolean::New(env, false));
-  Napi::Object parameter = Napi::Object::New(env);
-
-  if (isReset) {
-    // reset operation
-    if (classicalValueToMeasure == "0") {
-      dd->performCollapsingMeasurement(sim, qubit, pzero, true);
-    } else if (classicalValueToMeasure == "1") {
-      dd->performCollapsingMeasurement(sim, qubit, pone, false);
-      // apply x operation to reset to |0>
-      const auto x   = qc::StandardOperation(qubit, qc::X);
-      auto       tmp = dd->multiply(dd::getDD(&x, *dd), sim);
-      dd->incRef(tmp);
-      dd->decRef(sim);
-      sim = tmp;
-
-      dd->garbageCollect();
-    } else {
-      // do something in case operation is cancelled
-    }
-  } else {
-    // get target classical bit
-    auto cbit = static_cast<std::size_t>(
-        obj.Get("cbit").As<Napi::Number>().Int64Value());
-    if (classicalValueToMeasure != "none") {
-      const bool measureZero = (classicalValueToMeasure == "0");
-      dd->performCollapsingMeasurement(sim, qubit, measureZero ? pzero : pone,
-                                       measureZero);
-      measurements[cbit] = !measureZero;
-    }
-    cbit++;
-    parameter.Set("cbit", Napi::Number::New(env, static_cast<double>(cbit)));
-  }
-
-  count++;
-  if (count == total) {
-    state.Set("finished", Napi::Boolean::New(env, true));
-    return state;
-  }
-
-  // next qubit
-  qubit++;
-  std::tie(pzero, pone) =
-      dd->determineMeasurementProbabilities(sim, qubit, true);
+  if (const auto lock = tryLockEngine(env, *engine); lock.owns_lock())
+    engine->setProfiling(static_cast<bool>(info[0].As<Napi::Boolean>()));
+}
 
-  parameter.Set("qubit", Napi::Number::New(env, qubit));
-  parameter.Set("pzero", Napi::Number::New(env, pzero));
-  parameter.Set("pone", Napi::Number::New(env, pone));
-  parameter.Set("count", Napi::Number::New(env, static_cast<double>(count)));
-  parameter.Set("total", Napi::Number::New(env, static_cast<double>(total)));
-  state.Set("parameter", parameter);
+/**
+ * @param info has no parameters
+ * @return the statistics recorded while profiling was enabled as compact JSON
+ * (see Profiler::toJson)
+ */
+Napi::Value QDDVis::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env  env  = info.Env();
+  const auto lock = tryLockEngine(env, *engine);
+  if (!lock.owns_lock())
+    return env.Undefined();
+  return Napi::String::New(env, engine->getStats());
+}
 
-  return state;
+/**Builds the functionality DDs of all segments of the loaded circuit that do
+ * not have one yet on a worker thread. The lock is released after every
+ * segment, so other requests of the session are not held up in the meantime.
+ *
+ * @param info has no parameters
+ * @return a Promise resolving to the number of processed segments
+ */
+Napi::Value
+QDDVis::PrepareSegmentsAsync([[maybe_unused]] const Napi::CallbackInfo& info) {
+  auto* engine = this->engine.get();
+  return AsyncTask<std::size_t>::Queue(
+      Value(),
+      [engine]() {
+        std::size_t processed = 0;
+        while (true) {
+          const auto lock = engine->lock();
+          if (!engine->prepareSegment())
+            break;
+          ++processed;
+        }
+        return processed;
+      },
+      [](Napi::Env env, std::size_t& processed) -> Napi::Value {
+        return Napi::Number::New(env, static_cast<double>(processed));
+      });
 }
@@ -7,14 +7,12 @@
 #ifndef QDDVIS_H
 #define QDDVIS_H
 
-#include "dd/Operations.hpp"
-#include "dd/Package.hpp"
-#include "ir/QuantumComputation.hpp"
+#include "SimulationEngine.h"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <napi.h>
-#include <queue>
 #include <string>
 
 class QDDVis : public Napi::ObjectWrap<QDDVis> {
@@ -25,12 +23,6 @@ public:
 private:
   static inline Napi::FunctionReference constructor;
 
-  static constexpr unsigned short MAX_QUBITS_FOR_AMPLITUDES = 9;
-  //"private" methods
-  void stepForward();
-  void stepBack();
-  void calculateAmplitudes(Napi::Float32Array& amplitudes);
-
   // exported ("public") methods       - return type must be Napi::Value or
   // void!
   Napi::Value Load(const Napi::CallbackInfo& info);
@@ -40,32 +32,47 @@ private:
   Napi::Value ToEnd(const Napi::CallbackInfo& info);
   Napi::Value ToLine(const Napi::CallbackInfo& info);
   Napi::Value GetDD(const Napi::CallbackInfo& info);
+  Napi::Value GetDDDiff(const Napi::CallbackInfo& info);
+  Napi::Value GetGraph(const Napi::CallbackInfo& info);
   void        UpdateExportOptions(const Napi::CallbackInfo& info);
   Napi::Value GetExportOptions(const Napi::CallbackInfo& info);
+  void        SetGateFusion(const Napi::CallbackInfo& info);
+  void        SetSegmentMatrices(const Napi::CallbackInfo& info);
+  void        SetProfiling(const Napi::CallbackInfo& info);
+  Napi::Value GetStats(const Napi::CallbackInfo& info);
+  void        UpdateAmplitudeOptions(const Napi::CallbackInfo& info);
+  Napi::Value GetAmplitudeOptions(const Napi::CallbackInfo& info);
   Napi::Value IsReady(const Napi::CallbackInfo& info);
   void        Unready(const Napi::CallbackInfo& info);
   Napi::Value ConductIrreversibleOperation(const Napi::CallbackInfo& info);
+  void        BeginLoad(const Napi::CallbackInfo& info);
+  void        PushChunk(const Napi::CallbackInfo& info);
 
-  // fields
-  std::unique_ptr<dd::Package<>>          dd;
-  std::unique_ptr<qc::QuantumComputation> qc;
-  qc::VectorDD                            sim{};
-
-  std::vector<std::unique_ptr<qc::Operation>>::iterator iterator{};
-  unsigned int position = 0; // current position of the iterator
+  // Promise-returning variants that run on the libuv thread pool
+  Napi::Value LoadAsync(const Napi::CallbackInfo& info);
+  Napi::Value EndLoadAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToStartAsync(const Napi::CallbackInfo& info);
+  Napi::Value PrevAsync(const Napi::CallbackInfo& info);
+  Napi::Value NextAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToEndAsync(const Napi::CallbackInfo& info);
+  Napi::Value PrepareSegmentsAsync(const Napi::CallbackInfo& info);
+  Napi::Value ToLineAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetDDAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetAmplitudesAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetDDDiffAsync(const Napi::CallbackInfo& info);
+  Napi::Value GetGraphAsync(const Napi::CallbackInfo& info);
+  Napi::Value ConductIrreversibleOperationAsync(const Napi::CallbackInfo& info);
+  Napi::Value SaveStateAsync(const Napi::CallbackInfo& info);
+  Napi::Value RestoreStateAsync(const Napi::CallbackInfo& info);
 
-  std::vector<bool> measurements{};
-  bool ready = false; // true if a valid algorithm is imported, false otherwise
-  bool atInitial =
-      true; // whether we currently visualize the initial state or not
-  bool atEnd =
-      false; // whether we currently visualize the end of the given circuit
+  // fields
+  // shared with the SessionRegistry if the object belongs to a session
+  std::shared_ptr<SimulationEngine> engine;
 
-  // options for the DD export
-  bool showColors          = true;
-  bool showEdgeLabels      = true;
-  bool showClassic         = false;
-  bool usePolarCoordinates = true;
+  // algorithm received so far by pushChunk; its size is counted as memory
+  // usage of the session (see SimulationEngine::setStreamedBytes)
+  std::string streamedAlgorithm{};
+  bool        streaming = false;
 };
 
 #endif
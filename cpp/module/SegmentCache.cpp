@@ -0,0 +1,171 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "SegmentCache.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * @return true if the operation may be part of a segment, i.e., it is unitary,
+ * does not depend on measurement results and is not a barrier (toEnd stops at
+ * barriers)
+ */
+bool SegmentCache::isSegmentable(const qc::Operation& op) {
+  return op.isUnitary() && !op.isClassicControlledOperation() &&
+         op.getType() != qc::Barrier;
+}
+
+/**Computes the segments of the given circuit. The DDs of segments within the
+ * first `unchanged` operations are kept if the segment is found again; all
+ * other DDs are dropped and have to be built again by buildNext.
+ *
+ * @param qc the circuit (possibly replacing the one the cache was built for)
+ * @param unchanged number of leading operations that are the same as in the
+ * circuit the cache was built for (0 if it was built for no or another circuit)
+ */
+void SegmentCache::rebuild(const qc::QuantumComputation& qc,
+                           const std::size_t             unchanged) {
+  auto previous = std::move(segments);
+  segments.clear();
+  starts.clear();
+  pendingSegments = 0;
+
+  const auto   nops  = static_cast<unsigned int>(qc.getNops());
+  unsigned int start = 0;
+  while (start < nops) {
+    auto end = start;
+    while (end < nops && isSegmentable(*qc.at(end)))
+      ++end;
+
+    if (end - start >= MIN_OPERATIONS) {
+      Segment segment{start, end};
+      if (const auto it = previous.find(start);
+          it != previous.end() && it->second.end == end && end <= unchanged) {
+        segment = it->second; // takes over the references
+        previous.erase(it);
+      }
+      if (!segment.built && !segment.failed)
+        ++pendingSegments;
+      starts.emplace(end, start);
+      segments.emplace(start, segment);
+    }
+    // the operation at end (if any) cannot be part of a segment
+    start = end + 1;
+  }
+
+  for (auto& [position, segment] : previous)
+    release(segment);
+}
+
+/**Builds the DD of the first segment that does not have one yet. The DD is
+ * given up on as soon as it exceeds the node budget.
+ *
+ * @param qc the circuit the segments were computed for by rebuild
+ * @return true if a segment was processed, false if all segments are done
+ */
+bool SegmentCache::buildNext(const qc::QuantumComputation& qc) {
+  const auto it = std::find_if(
+      segments.begin(), segments.end(), [](const auto& entry) {
+        return !entry.second.built && !entry.second.failed;
+      });
+  if (it == segments.end())
+    return false;
+  auto& segment = it->second;
+  --pendingSegments;
+
+  // intermediate results are referenced, so garbage can be collected while a
+  // long segment is built
+  const auto replace = [this](qc::MatrixDD& target, const qc::MatrixDD& next) {
+    dd.incRef(next);
+    dd.decRef(target);
+    target = next;
+  };
+  auto matrix  = dd.makeIdent();
+  auto inverse = dd.makeIdent();
+  dd.incRef(matrix);
+  dd.incRef(inverse);
+
+  std::size_t nodes = 0;
+  for (auto position = segment.start; position < segment.end; ++position) {
+    const auto* op = qc.at(position).get();
+    replace(matrix, dd.multiply(dd::getDD(op, dd), matrix));
+    if (withInverse)
+      replace(inverse, dd.multiply(inverse, dd::getInverseDD(op, dd)));
+
+    if ((position + 1 - segment.start) % CHECK_INTERVAL == 0 ||
+        position + 1 == segment.end) {
+      nodes = matrix.size() + (withInverse ? inverse.size() : 0);
+      if (nodes > maxNodes) {
+        segment.failed = true;
+        break;
+      }
+      dd.garbageCollect();
+    }
+  }
+
+  if (segment.failed) {
+    dd.decRef(matrix);
+    dd.decRef(inverse);
+    return true;
+  }
+  segment.matrix = matrix;
+  segment.nodes  = nodes;
+  segment.built  = true;
+  builtNodes += nodes;
+  if (withInverse)
+    segment.inverse = inverse;
+  else
+    dd.decRef(inverse);
+  return true;
+}
+
+/**
+ * @return the segment starting at position, if its DD is built and it ends at
+ * or before limit, nullptr otherwise
+ */
+const SegmentCache::Segment*
+SegmentCache::forward(const unsigned int position,
+                      const unsigned int limit) const {
+  const auto it = segments.find(position);
+  if (it == segments.end() || !it->second.built || it->second.end > limit)
+    return nullptr;
+  return &it->second;
+}
+
+/**
+ * @return the segment ending at position, if its inverse DD is built and it
+ * starts at or after limit, nullptr otherwise
+ */
+const SegmentCache::Segment*
+SegmentCache::backward(const unsigned int position,
+                       const unsigned int limit) const {
+  const auto start = starts.find(position);
+  if (start == starts.end() || start->second < limit)
+    return nullptr;
+  const auto& segment = segments.at(start->second);
+  if (!segment.built || !withInverse)
+    return nullptr;
+  return &segment;
+}
+
+void SegmentCache::clear() {
+  for (auto& [position, segment] : segments)
+    release(segment);
+  segments.clear();
+  starts.clear();
+  pendingSegments = 0;
+}
+
+void SegmentCache::release(Segment& segment) {
+  if (segment.built) {
+    dd.decRef(segment.matrix);
+    if (withInverse)
+      dd.decRef(segment.inverse);
+  }
+  builtNodes -= segment.nodes;
+  segment = Segment{segment.start, segment.end};
+}
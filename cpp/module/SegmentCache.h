@@ -0,0 +1,92 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef SEGMENTCACHE_H
+#define SEGMENTCACHE_H
+
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+
+/**Holds the functionality DDs of the measurement-free segments of a circuit,
+ * i.e., of the maximal runs of unitary operations between measurements,
+ * resets, barriers and classically controlled operations. Jumping over a whole
+ * segment costs a single multiplication instead of one per operation.
+ *
+ * The boundaries of the segments are computed by rebuild, while the DDs are
+ * built one segment at a time by buildNext (usually in the background) and stay
+ * referenced until the circuit changes, so they are reused by every move across
+ * the segment. Segments whose functionality exceeds the node budget are given
+ * up on, since applying their operations one by one is cheaper.
+ */
+class SegmentCache {
+public:
+  // shorter runs of operations are not worth a functionality DD
+  static constexpr unsigned int MIN_OPERATIONS = 32;
+  // upper bound on the node count of the DD of a single segment
+  static constexpr std::size_t DEFAULT_MAX_NODES = 1U << 16U;
+  // number of operations applied between two checks of the node count
+  static constexpr unsigned int CHECK_INTERVAL = 32;
+
+  struct Segment {
+    unsigned int start  = 0;
+    unsigned int end    = 0;     // position after the last operation
+    bool         failed = false; // whether the DD exceeded the node budget
+    // whether the DDs are built (identity and terminal edges have no node, so
+    // the edges cannot tell)
+    bool         built = false;
+    std::size_t  nodes = 0;
+    qc::MatrixDD matrix{};  // functionality
+    qc::MatrixDD inverse{}; // only built if the cache builds inverses
+  };
+
+  /**Creates an empty cache. If withInverse is set, the inverse functionality
+   * of every segment is built as well, which is needed to jump backwards.
+   */
+  explicit SegmentCache(dd::Package<>& dd, bool withInverse = false,
+                        std::size_t    maxNodes = DEFAULT_MAX_NODES)
+      : dd(dd), withInverse(withInverse), maxNodes(maxNodes) {}
+  ~SegmentCache() { clear(); }
+
+  SegmentCache(const SegmentCache&)            = delete;
+  SegmentCache& operator=(const SegmentCache&) = delete;
+
+  void rebuild(const qc::QuantumComputation& qc, std::size_t unchanged);
+  bool buildNext(const qc::QuantumComputation& qc);
+  void clear();
+
+  [[nodiscard]] const Segment* forward(unsigned int position,
+                                       unsigned int limit) const;
+  [[nodiscard]] const Segment* backward(unsigned int position,
+                                        unsigned int limit) const;
+
+  [[nodiscard]] std::size_t size() const { return segments.size(); }
+  [[nodiscard]] std::size_t pending() const { return pendingSegments; }
+  [[nodiscard]] std::size_t nodes() const { return builtNodes; }
+
+  static bool isSegmentable(const qc::Operation& op);
+
+private:
+  void release(Segment& segment);
+
+  dd::Package<>& dd;
+  bool           withInverse;
+  std::size_t    maxNodes;
+  std::size_t    builtNodes      = 0;
+  std::size_t    pendingSegments = 0;
+
+  // segments by the position of their first operation
+  std::map<unsigned int, Segment> segments{};
+  // first operation of the segments by the position after their last operation
+  std::unordered_map<unsigned int, unsigned int> starts{};
+};
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include "dd/Package.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**Helpers for the binary files sessions are saved to. A file starts with a
+ * header identifying the kind of session, followed by the fields of the engine
+ * in native byte order. The serialized DD comes last, since dd::Package reads
+ * binary DDs until the end of the stream.
+ */
+namespace sessionfile {
+constexpr std::array<char, 4> MAGIC   = {'Q', 'D', 'D', 'S'};
+constexpr std::uint32_t       VERSION = 1;
+// upper bound for the length of a string or bit vector read from a file
+constexpr std::uint64_t MAX_LENGTH = std::uint64_t{1} << 32U;
+
+enum class Kind : std::uint8_t { Simulation = 0, Verification = 1 };
+
+// bits of the export options
+constexpr std::uint8_t COLORED     = 1U << 0U;
+constexpr std::uint8_t EDGE_LABELS = 1U << 1U;
+constexpr std::uint8_t CLASSIC     = 1U << 2U;
+constexpr std::uint8_t POLAR       = 1U << 3U;
+
+template <class T> void write(std::ostream& os, const T value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T> T read(std::istream& is) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  T value{};
+  if (!is.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    throw std::runtime_error("The session file is truncated!");
+  return value;
+}
+
+inline void writeString(std::ostream& os, const std::string& str) {
+  write<std::uint64_t>(os, str.size());
+  os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+/**Reads the length of a string or bit vector whose elements are stored perByte
+ * to a byte and checks it before anything is allocated.
+ *
+ * @throws std::runtime_error if the length exceeds MAX_LENGTH or the bytes
+ * left in the stream (if the stream can tell)
+ */
+inline std::uint64_t readLength(std::istream& is, const std::uint64_t perByte) {
+  const auto length = read<std::uint64_t>(is);
+  if (length > MAX_LENGTH)
+    throw std::runtime_error("The session file is corrupted!");
+
+  const auto current = is.tellg();
+  if (current != std::istream::pos_type(-1)) {
+    is.seekg(0, std::ios::end);
+    const auto end = is.tellg();
+    is.seekg(current);
+    if (end != std::istream::pos_type(-1) &&
+        (length + perByte - 1) / perByte >
+            static_cast<std::uint64_t>(end - current))
+      throw std::runtime_error("The session file is truncated!");
+  }
+  return length;
+}
+
+inline std::string readString(std::istream& is) {
+  std::string str(readLength(is, 1), '\0');
+  if (!is.read(str.data(), static_cast<std::streamsize>(str.size())))
+    throw std::runtime_error("The session file is truncated!");
+  return str;
+}
+
+inline void writeBits(std::ostream& os, const std::vector<bool>& bits) {
+  write<std::uint64_t>(os, bits.size());
+  for (std::size_t i = 0; i < bits.size(); i += 8) {
+    std::uint8_t byte = 0;
+    for (std::size_t j = i; j < bits.size() && j < i + 8; ++j)
+      byte |= static_cast<std::uint8_t>(bits[j]) << (j - i);
+    write(os, byte);
+  }
+}
+
+inline std::vector<bool> readBits(std::istream& is) {
+  std::vector<bool> bits(readLength(is, 8));
+  for (std::size_t i = 0; i < bits.size(); i += 8) {
+    const auto byte = read<std::uint8_t>(is);
+    for (std::size_t j = i; j < bits.size() && j < i + 8; ++j)
+      bits[j] = ((byte >> (j - i)) & 1U) != 0;
+  }
+  return bits;
+}
+
+/**Reads the DD that concludes a session file into the package and protects it
+ * from garbage collection. The package is enlarged if necessary, but never
+ * shrunk, since it may still hold the DDs of the running session.
+ *
+ * @param nqubits number of qubits of the saved circuit(s)
+ * @throws std::runtime_error if the DD does not fit the circuit(s)
+ */
+template <class Node>
+dd::Edge<Node> readDD(std::istream& is, dd::Package<>& dd,
+                      const std::size_t nqubits) {
+  if (dd.qubits() < nqubits)
+    dd.resize(nqubits);
+  const auto e = dd.deserialize<Node>(is, true);
+  const auto qubits =
+      e.isTerminal() ? std::size_t{0} : static_cast<std::size_t>(e.p->v) + 1;
+  // states span all qubits, while matrices may leave out the top ones
+  if (qubits > nqubits ||
+      (std::is_same_v<Node, dd::vNode> && qubits != nqubits))
+    throw std::runtime_error("The saved session is inconsistent!");
+  dd.incRef(e);
+  return e;
+}
+
+inline void writeHeader(std::ostream& os, const Kind kind) {
+  os.write(MAGIC.data(), MAGIC.size());
+  write(os, VERSION);
+  write(os, kind);
+}
+
+/**Checks the header of a session file.
+ *
+ * @throws std::runtime_error if the file is no session file of the given kind
+ * or was written by an incompatible version
+ */
+inline void readHeader(std::istream& is, const Kind kind) {
+  std::array<char, MAGIC.size()> magic{};
+  if (!is.read(magic.data(), magic.size()) || magic != MAGIC)
+    throw std::runtime_error("The file does not contain a saved session!");
+  if (read<std::uint32_t>(is) != VERSION)
+    throw std::runtime_error(
+        "The session was saved by an incompatible version!");
+  if (read<Kind>(is) != kind)
+    throw std::runtime_error("The session was saved by a different tool!");
+}
+
+/**Writes a session file through the given writer. The data goes to a
+ * temporary file first, so an existing file is only replaced by a complete one.
+ */
+template <class Writer> void save(const std::string& path, Writer&& writer) {
+  const auto tmp = path + ".tmp";
+  try {
+    std::ofstream ofs(tmp, std::ios::binary);
+    if (!ofs)
+      throw std::runtime_error("Could not create the session file!");
+    writer(ofs);
+    ofs.close();
+    if (!ofs)
+      throw std::runtime_error("Could not write the session file!");
+    std::filesystem::rename(tmp, path);
+  } catch (...) {
+    std::error_code ec{};
+    std::filesystem::remove(tmp, ec);
+    throw;
+  }
+}
+
+inline std::ifstream open(const std::string& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    throw std::runtime_error("The saved session does not exist!");
+  return ifs;
+}
+} // namespace sessionfile
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "SessionRegistry.h"
+
+#include <iterator>
+#include <mutex>
+#include <utility>
+
+MemoryUsage SessionRegistry::Session::usage() const {
+  MemoryUsage usage{};
+  if (simulation)
+    usage = simulation->cachedMemoryUsage();
+  if (verification) {
+    const auto verificationUsage = verification->cachedMemoryUsage();
+    usage.nodes += verificationUsage.nodes;
+    usage.bytes += verificationUsage.bytes;
+  }
+  return usage;
+}
+
+SessionRegistry::SessionRegistry() {
+  PackagePool::instance().setReclaimer(
+      [this](const void* requester) { return reclaimPackage(requester); });
+}
+
+SessionRegistry::~SessionRegistry() {
+  PackagePool::instance().setReclaimer({});
+}
+
+SessionRegistry& SessionRegistry::instance() {
+  static SessionRegistry registry{};
+  return registry;
+}
+
+std::shared_ptr<SimulationEngine>
+SessionRegistry::simulation(const std::string& key) {
+  std::lock_guard guard{mutex};
+  auto&           session = access(key);
+  if (!session.simulation)
+    session.simulation = std::make_shared<SimulationEngine>();
+  return session.simulation;
+}
+
+std::shared_ptr<VerificationEngine>
+SessionRegistry::verification(const std::string& key) {
+  std::lock_guard guard{mutex};
+  auto&           session = access(key);
+  if (!session.verification)
+    session.verification = std::make_shared<VerificationEngine>();
+  return session.verification;
+}
+
+bool SessionRegistry::touch(const std::string& key) {
+  std::lock_guard guard{mutex};
+  if (index.count(key) == 0)
+    return false;
+  access(key);
+  evictOverBudget();
+  return true;
+}
+
+bool SessionRegistry::remove(const std::string& key) {
+  std::lock_guard guard{mutex};
+  const auto      it = index.find(key);
+  if (it == index.end())
+    return false;
+  take(it->second, std::next(it->second));
+  return true;
+}
+
+std::vector<std::string>
+SessionRegistry::evictIdle(const std::chrono::milliseconds maxIdle) {
+  std::lock_guard guard{mutex};
+  const auto      oldest = Clock::now() - maxIdle;
+  // the sessions are ordered by their last access, so the idle ones are a
+  // suffix of the list
+  auto first = sessions.end();
+  while (first != sessions.begin() && std::prev(first)->lastAccess < oldest)
+    --first;
+  auto keys = take(first, sessions.end());
+  evictedIdle += keys.size();
+  return keys;
+}
+
+void SessionRegistry::setMemoryBudget(const std::size_t bytes) {
+  std::lock_guard guard{mutex};
+  memoryBudget = bytes;
+  evictOverBudget();
+}
+
+std::size_t SessionRegistry::getMemoryBudget() {
+  std::lock_guard guard{mutex};
+  return memoryBudget;
+}
+
+SessionRegistry::Stats SessionRegistry::stats() {
+  std::lock_guard guard{mutex};
+  Stats           stats{};
+  stats.memoryBudget       = memoryBudget;
+  stats.evictedForMemory   = evictedForMemory;
+  stats.evictedForPackages = evictedForPackages;
+  stats.evictedIdle        = evictedIdle;
+  stats.sessions.reserve(sessions.size());
+
+  const auto now = Clock::now();
+  for (const auto& session : sessions) {
+    const auto usage = session.usage();
+    stats.usage.nodes += usage.nodes;
+    stats.usage.bytes += usage.bytes;
+    stats.sessions.push_back(
+        {usage, std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - session.lastAccess)});
+  }
+  return stats;
+}
+
+/**Returns the session with the given key, creating it if necessary, and moves
+ * it to the front of the list.
+ */
+SessionRegistry::Session& SessionRegistry::access(const std::string& key) {
+  if (const auto it = index.find(key); it != index.end()) {
+    sessions.splice(sessions.begin(), sessions, it->second);
+  } else {
+    sessions.emplace_front();
+    sessions.front().key = key;
+    index.emplace(key, sessions.begin());
+  }
+  sessions.front().lastAccess = Clock::now();
+  return sessions.front();
+}
+
+/**Evicts the sessions using the most memory until the summed usage fits the
+ * memory budget again, sparing the most recently used session. Among sessions
+ * using the same amount, the least recently used one goes first.
+ */
+void SessionRegistry::evictOverBudget() {
+  std::size_t bytes = 0;
+  for (const auto& session : sessions)
+    bytes += session.usage().bytes;
+
+  while (bytes > memoryBudget && sessions.size() > 1) {
+    // the list is ordered by the last access, so later sessions win ties
+    auto largest = std::next(sessions.begin());
+    for (auto it = largest; it != sessions.end(); ++it) {
+      if (it->usage().bytes >= largest->usage().bytes)
+        largest = it;
+    }
+    bytes -= largest->usage().bytes;
+    take(largest, std::next(largest));
+    ++evictedForMemory;
+  }
+}
+
+/**Removes the given range of sessions from the registry. Their engines keep
+ * their packages until releaseEvicted runs.
+ *
+ * @return the keys of the removed sessions
+ */
+std::vector<std::string>
+SessionRegistry::take(SessionList::iterator first,
+                      const SessionList::iterator last) {
+  std::vector<std::string> keys{};
+  while (first != last) {
+    index.erase(first->key);
+    keys.emplace_back(first->key);
+    evicted.emplace_back(std::move(*first));
+    first = sessions.erase(first);
+  }
+  return keys;
+}
+
+bool SessionRegistry::releasePending() {
+  std::lock_guard guard{mutex};
+  return !evicted.empty();
+}
+
+/**Makes the engines of the removed sessions drop all DDs and return their
+ * packages to the pool. Engines that are busy are waited for, which is why
+ * this runs on a worker thread instead of the main thread.
+ */
+void SessionRegistry::releaseEvicted() {
+  std::vector<Session> released{};
+  {
+    std::lock_guard guard{mutex};
+    released.swap(evicted);
+  }
+  for (auto& session : released) {
+    if (session.simulation) {
+      const auto lock = session.simulation->lock();
+      session.simulation->releasePackage();
+    }
+    if (session.verification) {
+      const auto lock = session.verification->lock();
+      session.verification->releasePackage();
+    }
+  }
+}
+
+/**Evicts the least recently used session that holds a package and whose
+ * engines are not busy, and returns its packages to the pool right away. Busy
+ * engines are skipped instead of waited for, since the caller holds the lock
+ * of the requester. The session of the requester is never evicted (and its
+ * engines are not even tried, as the calling thread owns one of the locks).
+ *
+ * @return false if no session could be evicted
+ */
+bool SessionRegistry::reclaimPackage(const void* requester) {
+  std::lock_guard guard{mutex};
+  for (auto it = sessions.rbegin(); it != sessions.rend(); ++it) {
+    if (it->simulation.get() == requester ||
+        it->verification.get() == requester)
+      continue;
+    std::unique_lock<std::mutex> simulationLock{};
+    std::unique_lock<std::mutex> verificationLock{};
+    if (it->simulation) {
+      simulationLock = it->simulation->tryLock();
+      if (!simulationLock.owns_lock())
+        continue;
+    }
+    if (it->verification) {
+      verificationLock = it->verification->tryLock();
+      if (!verificationLock.owns_lock())
+        continue;
+    }
+    const bool simulationPackage =
+        it->simulation && it->simulation->hasPackage();
+    const bool verificationPackage =
+        it->verification && it->verification->hasPackage();
+    if (!simulationPackage && !verificationPackage)
+      continue;
+
+    if (simulationPackage)
+      it->simulation->releasePackage();
+    if (verificationPackage)
+      it->verification->releasePackage();
+    simulationLock   = {};
+    verificationLock = {};
+    index.erase(it->key);
+    sessions.erase(std::next(it).base());
+    ++evictedForPackages;
+    return true;
+  }
+  return false;
+}
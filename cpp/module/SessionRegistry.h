@@ -0,0 +1,125 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef SESSIONREGISTRY_H
+#define SESSIONREGISTRY_H
+
+#include "PackagePool.h"
+#include "SimulationEngine.h"
+#include "VerificationEngine.h"
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**Keeps track of the engines of all sessions, keyed by the session key the
+ * server hands out on registration. The memory usage of a session is the one
+ * its engines measured at the end of their last operation (see EngineLock), so
+ * accesses never traverse DDs. Whenever the summed usage exceeds the memory
+ * budget, the sessions using the most memory are evicted first, so a single
+ * heavy session cannot push out many light ones: their engines drop all DDs
+ * and return their packages to the pool as soon as releaseEvicted runs on a
+ * worker thread, instead of whenever the garbage collector of JavaScript
+ * finalizes the objects.
+ *
+ * The session that was accessed last is never evicted for memory, so a single
+ * session may exceed the budget while it is in use, but it is the first to go
+ * once other sessions are accessed.
+ *
+ * The registry also reclaims packages for the PackagePool: if all packages are
+ * in use when a session loads a circuit, the least recently used session that
+ * holds a package and is not busy is evicted and its packages are returned
+ * right away, so idle sessions cannot lock out active ones.
+ */
+class SessionRegistry {
+public:
+  static constexpr std::size_t DEFAULT_MEMORY_BUDGET = std::size_t{1} << 30U;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct SessionStats {
+    MemoryUsage               usage{};
+    std::chrono::milliseconds idle{};
+  };
+  struct Stats {
+    MemoryUsage usage{}; // summed over all sessions
+    std::size_t memoryBudget       = 0;
+    std::size_t evictedForMemory   = 0;
+    std::size_t evictedForPackages = 0;
+    std::size_t evictedIdle        = 0;
+    // most recently used first; keys are left out since they grant access
+    std::vector<SessionStats> sessions{};
+  };
+
+  static SessionRegistry& instance();
+
+  SessionRegistry(const SessionRegistry&)            = delete;
+  SessionRegistry& operator=(const SessionRegistry&) = delete;
+
+  // return the engine of the session, creating the session if necessary
+  std::shared_ptr<SimulationEngine>   simulation(const std::string& key);
+  std::shared_ptr<VerificationEngine> verification(const std::string& key);
+
+  /**Marks the session as used and evicts other sessions if the memory budget
+   * is exceeded.
+   *
+   * @return false if the session does not exist (anymore)
+   */
+  bool touch(const std::string& key);
+  bool remove(const std::string& key);
+  // evicts all sessions that have not been accessed for maxIdle and returns
+  // their keys
+  std::vector<std::string> evictIdle(std::chrono::milliseconds maxIdle);
+
+  void                      setMemoryBudget(std::size_t bytes);
+  [[nodiscard]] std::size_t getMemoryBudget();
+  Stats                     stats();
+
+  // whether evicted sessions wait for releaseEvicted
+  [[nodiscard]] bool releasePending();
+  // blocks until the engines of the evicted sessions are idle, so it must be
+  // called on a worker thread
+  void releaseEvicted();
+  // called by the PackagePool once all packages are in use
+  bool reclaimPackage(const void* requester);
+
+private:
+  struct Session {
+    std::string                         key{};
+    std::shared_ptr<SimulationEngine>   simulation{};
+    std::shared_ptr<VerificationEngine> verification{};
+    Clock::time_point                   lastAccess{};
+
+    [[nodiscard]] MemoryUsage usage() const;
+  };
+  using SessionList = std::list<Session>; // most recently used first
+
+  SessionRegistry();
+  ~SessionRegistry();
+
+  // the following methods require the mutex to be held
+  Session&                 access(const std::string& key);
+  void                     evictOverBudget();
+  std::vector<std::string> take(SessionList::iterator first,
+                                SessionList::iterator last);
+
+  std::mutex                                             mutex;
+  SessionList                                            sessions{};
+  std::unordered_map<std::string, SessionList::iterator> index{};
+  // removed sessions whose engines still hold their packages
+  std::vector<Session> evicted{};
+  std::size_t memoryBudget       = DEFAULT_MEMORY_BUDGET;
+  std::size_t evictedForMemory   = 0;
+  std::size_t evictedForPackages = 0;
+  std::size_t evictedIdle        = 0;
+};
+
+#endif
@@ -0,0 +1,1436 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "SimulationEngine.h"
+
+#include "CircuitCache.h"
+#include "SessionFile.h"
+#include "dd/Export.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+// first visit of a node: offset of the sub-vector it represents and the
+// accumulated weight it was written with
+using VisitedNodes =
+    std::unordered_map<const dd::vNode*,
+                       std::pair<std::size_t, std::complex<dd::fp>>>;
+
+/**Writes the sub-vector represented by the given edge to
+ * amplitudes[2 * offset, 2 * (offset + 2^level)) (real and imaginary part
+ * alternating). Zero edges are skipped since the amplitudes are initialized
+ * with zero, and nodes that were already visited are not traversed again:
+ * their sub-vector is a scaled copy of the one written on the first visit.
+ *
+ * @param e the edge to traverse
+ * @param level number of qubits the edge spans
+ * @param offset index of the first amplitude of the sub-vector
+ * @param weight product of the edge weights on the path to e
+ */
+void fillAmplitudes(const qc::VectorDD& e, const std::size_t level,
+                    const std::size_t offset, std::complex<dd::fp> weight,
+                    float* amplitudes, VisitedNodes& visited) {
+  if (e.w.exactlyZero())
+    return;
+  weight *= static_cast<std::complex<dd::fp>>(e.w);
+
+  const std::size_t size = 1ULL << level;
+  if (e.isTerminal()) {
+    for (std::size_t i = offset; i < offset + size; ++i) {
+      amplitudes[2 * i]     = static_cast<float>(weight.real());
+      amplitudes[2 * i + 1] = static_cast<float>(weight.imag());
+    }
+    return;
+  }
+
+  if (const auto it = visited.find(e.p); it != visited.end()) {
+    const auto& [firstOffset, firstWeight] = it->second;
+    const auto factor                      = weight / firstWeight;
+    for (std::size_t i = 0; i < size; ++i) {
+      const auto from = 2 * (firstOffset + i);
+      const auto to   = 2 * (offset + i);
+      const auto value =
+          factor * std::complex<dd::fp>{amplitudes[from], amplitudes[from + 1]};
+      amplitudes[to]     = static_cast<float>(value.real());
+      amplitudes[to + 1] = static_cast<float>(value.imag());
+    }
+    return;
+  }
+  visited.emplace(e.p, std::pair{offset, weight});
+
+  fillAmplitudes(e.p->e[0], level - 1, offset, weight, amplitudes, visited);
+  fillAmplitudes(e.p->e[1], level - 1, offset + size / 2, weight, amplitudes,
+                 visited);
+}
+
+void appendAmplitude(SimulationEngine::ExportResult& result,
+                     const std::uint64_t               index,
+                     const std::complex<dd::fp>        value) {
+  result.indices.emplace_back(index);
+  result.amplitudes.emplace_back(static_cast<float>(value.real()));
+  result.amplitudes.emplace_back(static_cast<float>(value.imag()));
+}
+
+/**Appends the nonzero amplitudes of the sub-vector represented by the given
+ * edge in the order of their indices until limit amplitudes were collected.
+ * Only the nonzero paths of the DD are traversed.
+ *
+ * @param level number of qubits the edge spans
+ * @param index index of the first amplitude of the sub-vector
+ * @param weight product of the edge weights on the path to e
+ */
+void collectNonZeroAmplitudes(const qc::VectorDD& e, const std::size_t level,
+                              const std::uint64_t  index,
+                              std::complex<dd::fp> weight,
+                              const std::size_t    limit,
+                              SimulationEngine::ExportResult& result) {
+  if (result.indices.size() >= limit || e.w.exactlyZero())
+    return;
+  weight *= static_cast<std::complex<dd::fp>>(e.w);
+
+  if (e.isTerminal()) {
+    for (std::uint64_t i = 0;
+         i < (1ULL << level) && result.indices.size() < limit; ++i)
+      appendAmplitude(result, index + i, weight);
+    return;
+  }
+  collectNonZeroAmplitudes(e.p->e[0], level - 1, index, weight, limit, result);
+  collectNonZeroAmplitudes(e.p->e[1], level - 1,
+                           index | (1ULL << (level - 1)), weight, limit,
+                           result);
+}
+
+/**
+ * @return the largest magnitude of an amplitude in the sub-vector represented
+ * by the given node (ignoring the weight of the incoming edge)
+ */
+dd::fp largestMagnitude(const dd::vNode*                              p,
+                        std::unordered_map<const dd::vNode*, dd::fp>& memo) {
+  if (dd::vNode::isTerminal(p))
+    return 1.;
+  if (const auto it = memo.find(p); it != memo.end())
+    return it->second;
+
+  dd::fp largest = 0.;
+  for (const auto& child : p->e) {
+    if (!child.w.exactlyZero())
+      largest = std::max(largest,
+                         std::abs(static_cast<std::complex<dd::fp>>(child.w)) *
+                             largestMagnitude(child.p, memo));
+  }
+  memo.emplace(p, largest);
+  return largest;
+}
+
+/**Appends the limit amplitudes with the largest magnitude (sorted by index).
+ * The paths of the DD are explored best first: the bound of a partial path is
+ * the magnitude of its weight times the largest magnitude below its node, so
+ * complete paths are reached in the order of decreasing magnitude.
+ */
+void collectLargestAmplitudes(const qc::VectorDD& root,
+                              const std::size_t   nqubits,
+                              const std::size_t   limit,
+                              SimulationEngine::ExportResult& result) {
+  struct Candidate {
+    dd::fp               bound = 0.;
+    qc::VectorDD         edge{};
+    std::size_t          level = 0;
+    std::uint64_t        index = 0;
+    std::complex<dd::fp> weight{};
+
+    bool operator<(const Candidate& other) const {
+      return bound < other.bound;
+    }
+  };
+
+  std::unordered_map<const dd::vNode*, dd::fp> memo{};
+  std::priority_queue<Candidate>               candidates{};
+  const auto push = [&](const qc::VectorDD& e, const std::size_t level,
+                        const std::uint64_t         index,
+                        const std::complex<dd::fp>& weight) {
+    if (e.w.exactlyZero())
+      return;
+    const auto w = weight * static_cast<std::complex<dd::fp>>(e.w);
+    candidates.push({std::abs(w) * largestMagnitude(e.p, memo), e, level,
+                     index, w});
+  };
+
+  push(root, nqubits, 0, 1.);
+  std::vector<std::pair<std::uint64_t, std::complex<dd::fp>>> largest{};
+  while (!candidates.empty() && largest.size() < limit) {
+    const auto candidate = candidates.top();
+    candidates.pop();
+    if (candidate.edge.isTerminal()) {
+      for (std::uint64_t i = 0;
+           i < (1ULL << candidate.level) && largest.size() < limit; ++i)
+        largest.emplace_back(candidate.index + i, candidate.weight);
+      continue;
+    }
+    const auto& children = candidate.edge.p->e;
+    push(children[0], candidate.level - 1, candidate.index, candidate.weight);
+    push(children[1], candidate.level - 1,
+         candidate.index | (1ULL << (candidate.level - 1)), candidate.weight);
+  }
+
+  std::sort(largest.begin(), largest.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& [index, value] : largest)
+    appendAmplitude(result, index, value);
+}
+} // namespace
+
+SimulationEngine::SimulationEngine() {
+  this->qc = std::make_unique<qc::QuantumComputation>();
+
+  this->iterator = this->qc->begin();
+  this->position = 0;
+}
+
+SimulationEngine::~SimulationEngine() { releasePackage(); }
+
+/**Takes a DD package from the pool, unless the session already has one. The
+ * package is only acquired once a circuit is loaded, so sessions that never
+ * load a circuit do not occupy a package.
+ */
+void SimulationEngine::acquirePackage(const std::size_t nqubits) {
+  if (dd)
+    return;
+  dd       = PackagePool::instance().acquire(nqubits, this);
+  opCache  = std::make_unique<OperationCache>(*dd);
+  segments = std::make_unique<SegmentCache>(*dd);
+  dotCache = std::make_unique<DotCache<dd::vNode>>(*dd);
+}
+
+/**Drops the loaded circuit together with all DDs of the session and returns
+ * the package to the pool right away. A circuit has to be loaded again before
+ * the engine can be used.
+ */
+void SimulationEngine::releasePackage() {
+  if (!dd)
+    return;
+  clearCheckpoints();
+  clearFusedBlocks();
+  if (sim.p != nullptr) {
+    dd->decRef(sim);
+    sim = {};
+  }
+  graph.clear();
+  // the caches reference nodes of the package, so they go first
+  opCache.reset();
+  segments.reset();
+  dotCache.reset();
+  PackagePool::instance().release(std::move(dd));
+
+  qc       = std::make_unique<qc::QuantumComputation>();
+  iterator = qc->begin();
+  position = 0;
+  measurements.clear();
+  irreversiblePositions.clear();
+  ready     = false;
+  atInitial = true;
+  atEnd     = false;
+}
+
+/**Counts the nodes of the DDs the session references: the current state, the
+ * checkpoints, the fused blocks, the segments, the cached operation DDs and the
+ * DDs whose DOT strings are cached (the strings are part of the bytes, just
+ * like the text of the loaded algorithm). Nodes shared between several of
+ * these DDs are counted once per DD.
+ */
+MemoryUsage SimulationEngine::memoryUsage() const {
+  MemoryUsage usage{};
+  if (!dd)
+    return usage;
+
+  auto vectorNodes = checkpointNodes + dotCache->nodes();
+  if (sim.p != nullptr)
+    vectorNodes += sim.size();
+  auto matrixNodes = opCache->nodes() + segments->nodes();
+  for (const auto& [start, block] : fusedBlocks) {
+    if (block.built)
+      matrixNodes += block.matrix.size();
+  }
+  usage.nodes = vectorNodes + matrixNodes;
+  usage.bytes = vectorNodes * sizeof(dd::vNode) +
+                matrixNodes * sizeof(dd::mNode) + dotCache->bytes() +
+                algorithm.capacity();
+  return usage;
+}
+
+MemoryUsage SimulationEngine::cachedMemoryUsage() const {
+  return {usageNodes.load(), usageBytes.load() + streamedBytes.load()};
+}
+
+/**Measures the memory usage for cachedMemoryUsage. Called by Lock before it
+ * releases the engine.
+ */
+void SimulationEngine::finishOperation() {
+  const auto usage = memoryUsage();
+  usageNodes       = usage.nodes;
+  usageBytes       = usage.bytes;
+}
+
+/**Applies the current operation/DD (determined by iterator) and increments both
+ * iterator and position. If iterator reaches its end, atEnd will be set to
+ * true.
+ *
+ * @param batched whether the step is part of a multi-step move, in which case
+ * garbage collection is deferred (see collectGarbage)
+ */
+void SimulationEngine::stepForward(const bool batched) {
+  if (atEnd)
+    return; // no further steps possible
+  auto measurement = profiler.measure(dd->matrixVectorMultiplication, position,
+                                      1, (*iterator)->getType(), false);
+  qc::MatrixDD currDD{};
+  if ((*iterator)->isClassicControlledOperation()) {
+    auto startIndex = static_cast<dd::Qubit>((*iterator)->getParameter().at(0));
+    auto length = static_cast<std::size_t>((*iterator)->getParameter().at(1));
+    auto expectedValue =
+        static_cast<std::size_t>((*iterator)->getParameter().at(2));
+
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+      value |= (static_cast<std::size_t>(measurements[startIndex + i]) << i);
+    }
+
+    if (value == expectedValue) {
+      currDD = opCache->get(iterator->get(),
+                            false); // retrieve the "new" current operation
+    } else {
+      currDD = dd->makeIdent();
+    }
+  } else {
+    currDD = opCache->get(iterator->get(),
+                          false); // retrieve the "new" current operation
+  }
+  measurement.lap(&Profiler::Sample::getDD);
+
+  auto temp =
+      dd->multiply(currDD, sim); // process the current operation by multiplying
+                                 // it with the previous simulation-state
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(batched);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  measurement.finish(dd->matrixVectorMultiplication, sim);
+
+  iterator++; // advance iterator
+  position++;
+  if (iterator ==
+      qc->end()) { // qc1->end() is after the last operation in the iterator
+    atEnd = true;
+  }
+
+  if (position % checkpointInterval == 0 && checkpoints.count(position) == 0) {
+    storeCheckpoint();
+  }
+}
+
+/**If either atInitial is true or the iterator is at the beginning, this method
+ * does nothing. In other cases it will first decrement both position and
+ * iterator before applying the inverse of the operation/DD the iterator is then
+ * pointing at.
+ *
+ * @param batched whether the step is part of a multi-step move, in which case
+ * garbage collection is deferred (see collectGarbage)
+ */
+void SimulationEngine::stepBack(const bool batched) {
+  if (atInitial)
+    return; // no step back possible
+
+  if (iterator == qc->begin()) {
+    atInitial = true;
+    return;
+  }
+
+  iterator--; // set iterator back to the desired operation
+  position--;
+
+  auto measurement = profiler.measure(dd->matrixVectorMultiplication, position,
+                                      1, (*iterator)->getType(), true);
+  qc::MatrixDD currDD{};
+  if ((*iterator)->isClassicControlledOperation()) {
+    auto startIndex = static_cast<dd::Qubit>((*iterator)->getParameter().at(0));
+    auto length = static_cast<std::size_t>((*iterator)->getParameter().at(1));
+    auto expectedValue =
+        static_cast<std::size_t>((*iterator)->getParameter().at(2));
+
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+      value |= (static_cast<std::size_t>(measurements[startIndex + i]) << i);
+    }
+
+    if (value == expectedValue) {
+      currDD = opCache->get(iterator->get(),
+                            true); // get the inverse of the current operation
+    } else {
+      currDD = dd->makeIdent();
+    }
+  } else {
+    currDD = opCache->get(iterator->get(),
+                          true); // get the inverse of the current operation
+  }
+  measurement.lap(&Profiler::Sample::getDD);
+
+  auto temp = dd->multiply(
+      currDD,
+      sim); //"remove" the current operation by multiplying with its inverse
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(batched);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  measurement.finish(dd->matrixVectorMultiplication, sim);
+}
+
+/**Advances the simulation as part of a multi-step move. If a segment whose
+ * functionality DD is built starts at the current position and ends at or
+ * before limit, the whole segment is applied with a single multiplication. The
+ * same holds for fused blocks if gate fusion is enabled. Otherwise, this is a
+ * single batched stepForward.
+ *
+ * @param limit position the move must not go beyond
+ * @return the number of operations that were applied
+ */
+unsigned int SimulationEngine::advance(const unsigned int limit) {
+  if (segmentMatrices && !atEnd) {
+    if (const auto* segment = segments->forward(position, limit)) {
+      auto measurement = measureJump(segment->end);
+      return jump(segment->end, segment->matrix, measurement);
+    }
+  }
+
+  const auto it = fusedBlocks.find(position);
+  if (!gateFusion || atEnd || it == fusedBlocks.end() ||
+      it->second.end > limit) {
+    stepForward(true);
+    return 1;
+  }
+
+  auto& block       = it->second;
+  auto  measurement = measureJump(block.end);
+  if (!block.built) {
+    // the gate DDs are shared with single steps over the same operations
+    block.matrix = opCache->get(iterator->get(), false);
+    for (auto op = std::next(iterator);
+         op != qc->begin() + static_cast<std::ptrdiff_t>(block.end); ++op) {
+      block.matrix = dd->multiply(opCache->get(op->get(), false), block.matrix);
+    }
+    dd->incRef(block.matrix);
+    block.built = true;
+  }
+  measurement.lap(&Profiler::Sample::getDD);
+  return jump(block.end, block.matrix, measurement);
+}
+
+/**Starts measuring a jump from the current position to end (see Profiler).
+ */
+Profiler::Measurement SimulationEngine::measureJump(const unsigned int end) {
+  return profiler.measure(dd->matrixVectorMultiplication, position,
+                          end - position, (*iterator)->getType(), false);
+}
+
+/**Applies the DD of all operations from the current position to end with a
+ * single multiplication as part of a multi-step move.
+ *
+ * @return the number of operations that were applied
+ */
+unsigned int SimulationEngine::jump(const unsigned int     end,
+                                    const qc::MatrixDD&    matrix,
+                                    Profiler::Measurement& measurement) {
+  auto temp = dd->multiply(matrix, sim);
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(true);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  measurement.finish(dd->matrixVectorMultiplication, sim);
+
+  const auto applied = end - position;
+  iterator += static_cast<std::ptrdiff_t>(applied);
+  position = end;
+  if (iterator == qc->end())
+    atEnd = true;
+
+  // fused blocks never cross a multiple of the checkpoint interval, while
+  // segments may skip the positions in between
+  if (position % checkpointInterval == 0 && checkpoints.count(position) == 0) {
+    storeCheckpoint();
+  }
+  return applied;
+}
+
+/**Gives the package the chance to collect garbage. Single steps do so after
+ * every operation, while multi-step moves only do so every BATCH_GC_INTERVAL
+ * operations. Collecting clears the compute tables, so deferring it lets
+ * consecutive operations of a batch reuse each other's intermediate results.
+ *
+ * @param batched whether the calling step is part of a multi-step move
+ */
+void SimulationEngine::collectGarbage(const bool batched) {
+  if (batched && ++uncollectedSteps < BATCH_GC_INTERVAL)
+    return;
+  uncollectedSteps = 0;
+  dd->garbageCollect();
+}
+
+/**Collects the garbage a multi-step move left behind (if any).
+ */
+void SimulationEngine::finishBatch() {
+  if (uncollectedSteps > 0)
+    collectGarbage(false);
+}
+
+/**Writes all amplitudes of the current state to the given array (real and
+ * imaginary part alternating) with a single traversal of the DD, which visits
+ * every node once.
+ */
+void SimulationEngine::calculateAmplitudes(float* amplitudes) const {
+  std::fill_n(amplitudes, 2ULL << qc->getNqubits(), 0.F);
+  VisitedNodes visited{};
+  fillAmplitudes(sim, qc->getNqubits(), 0, 1., amplitudes, visited);
+}
+
+void SimulationEngine::checkReady() const {
+  if (!ready)
+    throw std::runtime_error("No algorithm loaded!");
+}
+
+/**
+ * @return true if the operation the iterator points at is a measurement or
+ * reset
+ */
+bool SimulationEngine::nextIsIrreversible() const {
+  return iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
+                                   (*iterator)->getType() == qc::Reset);
+}
+
+/**
+ * @return true if the last processed operation is a measurement or reset
+ */
+bool SimulationEngine::previousIsIrreversible() const {
+  if (iterator == qc->begin())
+    return false;
+  auto testForMeasureIt = iterator;
+  --testForMeasureIt;
+  return (*testForMeasureIt)->getType() == qc::Measure ||
+         (*testForMeasureIt)->getType() == qc::Reset;
+}
+
+/**Stores a snapshot of the current simulation state (including the measurement
+ * results it depends on) for the current position. The snapshot keeps a
+ * reference on the DD so it survives garbage collection.
+ *
+ * @param pinned whether the checkpoint must not be dropped when thinning out
+ * the checkpoints (used for the states directly after irreversible operations)
+ */
+void SimulationEngine::storeCheckpoint(const bool pinned) {
+  if (position == 0)
+    return; // the initial state can always be recreated
+
+  if (const auto it = checkpoints.find(position); it != checkpoints.end()) {
+    dd->decRef(it->second.state);
+    checkpointNodes -= it->second.nodes;
+    checkpoints.erase(it);
+  }
+
+  Checkpoint checkpoint{sim, measurements, sim.size(), pinned};
+  dd->incRef(checkpoint.state);
+  checkpointNodes += checkpoint.nodes;
+  checkpoints.emplace(position, std::move(checkpoint));
+
+  if (checkpointNodes > MAX_CHECKPOINT_NODES)
+    thinOutCheckpoints();
+}
+
+/**Removes all checkpoints at or after the given position, e.g., because the
+ * state they captured is no longer reachable.
+ *
+ * @param from first position whose checkpoint is invalidated
+ */
+void SimulationEngine::invalidateCheckpoints(const unsigned int from) {
+  auto it = checkpoints.lower_bound(from);
+  while (it != checkpoints.end()) {
+    dd->decRef(it->second.state);
+    checkpointNodes -= it->second.nodes;
+    it = checkpoints.erase(it);
+  }
+}
+
+void SimulationEngine::clearCheckpoints() {
+  invalidateCheckpoints(0);
+  checkpointInterval = CHECKPOINT_INTERVAL;
+}
+
+/**Doubles the checkpoint interval and drops every checkpoint that is not
+ * aligned to the new interval until the checkpoints fit the node budget again.
+ * Pinned checkpoints are never dropped.
+ */
+void SimulationEngine::thinOutCheckpoints() {
+  while (checkpointNodes > MAX_CHECKPOINT_NODES &&
+         checkpointInterval < std::numeric_limits<unsigned int>::max() / 2) {
+    checkpointInterval *= 2;
+    for (auto it = checkpoints.begin(); it != checkpoints.end();) {
+      if (!it->second.pinned && it->first % checkpointInterval != 0) {
+        dd->decRef(it->second.state);
+        checkpointNodes -= it->second.nodes;
+        it = checkpoints.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+/**
+ * @param targetPos position that should be reached
+ * @return the position of the closest checkpoint at or before targetPos (0 if
+ * there is none, since the initial state can always be recreated)
+ */
+unsigned int
+SimulationEngine::closestCheckpoint(const unsigned int targetPos) const {
+  auto it = checkpoints.upper_bound(targetPos);
+  if (it == checkpoints.begin())
+    return 0;
+  --it;
+  return it->first;
+}
+
+/**Sets sim, the measurement results, iterator and position to the state stored
+ * for the given position. Position 0 restores the initial state.
+ *
+ * @param checkpointPos position of the checkpoint (as returned by
+ * closestCheckpoint)
+ */
+void SimulationEngine::restoreCheckpoint(const unsigned int checkpointPos) {
+  dd->decRef(sim);
+  if (checkpointPos == 0) {
+    sim = dd->makeZeroState(qc->getNqubits());
+    std::fill(measurements.begin(), measurements.end(), false);
+  } else {
+    const auto& checkpoint = checkpoints.at(checkpointPos);
+    sim                    = checkpoint.state;
+    measurements           = checkpoint.measurements;
+  }
+  dd->incRef(sim);
+
+  iterator  = qc->begin() + static_cast<std::ptrdiff_t>(checkpointPos);
+  position  = checkpointPos;
+  atInitial = (position == 0);
+  atEnd     = (iterator == qc->end());
+}
+
+/**
+ * @return true if a measurement or reset is located at a position in [from, to)
+ */
+bool SimulationEngine::irreversibleBetween(const unsigned int from,
+                                           const unsigned int to) const {
+  const auto it = std::lower_bound(irreversiblePositions.begin(),
+                                   irreversiblePositions.end(), from);
+  return it != irreversiblePositions.end() && *it < to;
+}
+
+/**
+ * @return true if the operation may be part of a fused block, i.e., it is a
+ * unitary acting on at most two qubits that does not depend on measurement
+ * results and is not a barrier (toEnd stops at barriers)
+ */
+bool SimulationEngine::isFusable(const qc::Operation& op) {
+  return op.isStandardOperation() && !op.isClassicControlledOperation() &&
+         op.getType() != qc::Barrier && op.getUsedQubits().size() <= 2;
+}
+
+/**Groups runs of adjacent fusable operations into blocks that act on at most
+ * MAX_FUSED_QUBITS qubits. Blocks never cross a multiple of
+ * CHECKPOINT_INTERVAL, so applying them does not skip the positions
+ * checkpoints are stored at. The block DDs are built lazily by advance.
+ */
+void SimulationEngine::buildFusedBlocks() {
+  clearFusedBlocks();
+
+  const auto   nops  = static_cast<unsigned int>(qc->getNops());
+  unsigned int start = 0;
+  while (start < nops) {
+    std::set<qc::Qubit> qubits{};
+    unsigned int        end = start;
+    while (end < nops && end - start < MAX_FUSED_OPERATIONS &&
+           (end == start || end % CHECKPOINT_INTERVAL != 0)) {
+      const auto& op = *qc->at(end);
+      if (!isFusable(op))
+        break;
+      auto used = op.getUsedQubits();
+      used.insert(qubits.begin(), qubits.end());
+      if (used.size() > MAX_FUSED_QUBITS)
+        break;
+      qubits = std::move(used);
+      ++end;
+    }
+
+    if (end - start > 1) {
+      fusedBlocks.emplace(start, FusedBlock{end, {}});
+      start = end;
+    } else {
+      ++start;
+    }
+  }
+}
+
+void SimulationEngine::clearFusedBlocks() {
+  for (auto& [start, block] : fusedBlocks) {
+    if (block.built)
+      dd->decRef(block.matrix);
+  }
+  fusedBlocks.clear();
+}
+
+/**Enables or disables applying fused blocks of operations in multi-step moves
+ * (toEnd, toLine and load). The visible positions are the same either way.
+ */
+void SimulationEngine::setGateFusion(const bool enabled) {
+  if (enabled == gateFusion)
+    return;
+  gateFusion = enabled;
+  if (gateFusion)
+    buildFusedBlocks();
+  else
+    clearFusedBlocks();
+}
+
+/**Enables or disables applying the functionality DDs of the measurement-free
+ * segments of the circuit in multi-step moves (toEnd, toLine and load). The
+ * DDs are not built here but by prepareSegment, so enabling is cheap.
+ */
+void SimulationEngine::setSegmentMatrices(const bool enabled) {
+  if (enabled == segmentMatrices)
+    return;
+  segmentMatrices = enabled;
+  if (!segments)
+    return; // the segments are computed once a circuit is loaded
+  if (segmentMatrices)
+    segments->rebuild(*qc, 0);
+  else
+    segments->clear();
+}
+
+/**Builds the functionality DD of the next segment that does not have one yet.
+ * Meant to be called repeatedly from the background, taking the lock for one
+ * segment at a time so the user is not held up for long.
+ *
+ * @return true if a segment was processed, false if there is nothing to do
+ */
+bool SimulationEngine::prepareSegment() {
+  if (!ready || !segmentMatrices)
+    return false;
+  return segments->buildNext(*qc);
+}
+
+/**Enables or disables recording the durations, DD sizes and compute table hit
+ * ratios of the single steps (see Profiler). Enabling discards the statistics
+ * recorded so far.
+ */
+void SimulationEngine::setProfiling(const bool enabled) {
+  profiler.setEnabled(enabled);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**Imports the passed algorithm and replaces the loaded circuit with it. Only
+ * the operations after the first edited one are treated as new: the
+ * checkpoints, cached operation DDs, fused blocks and segments of the
+ * operations before are kept.
+ */
+void SimulationEngine::replaceCircuit(std::string        algo,
+                                      const unsigned int formatCode) {
+  // the algorithm is imported into a new object, so the previous one stays
+  // intact if the import fails and can be compared to the new one
+  std::unique_ptr<qc::QuantumComputation> newQc{};
+  try {
+    newQc = CircuitCache::instance().import(
+        algo, formatCode == 1 ? qc::Format::OpenQASM3 : qc::Format::Real);
+  } catch (const std::exception& e) {
+    std::cout << "Exception while loading the algorithm: " << e.what() << "\n";
+    throw;
+  }
+  acquirePackage(newQc->getNqubits());
+
+  const auto unchanged =
+      static_cast<unsigned int>(unchangedOperations(*qc, *newQc));
+  // checkpoints stay valid as long as the operations before them are unchanged
+  if (newQc->getNqubits() != qc->getNqubits())
+    clearCheckpoints();
+  else
+    invalidateCheckpoints(unchanged + 1);
+
+  // fused blocks within the unchanged operations are built the same way again,
+  // so their DDs can be reused
+  std::map<unsigned int, FusedBlock> unchangedBlocks{};
+  while (!fusedBlocks.empty() && fusedBlocks.begin()->second.end <= unchanged)
+    unchangedBlocks.insert(fusedBlocks.extract(fusedBlocks.begin()));
+  clearFusedBlocks();
+  opCache->transfer(*qc, *newQc, unchanged);
+  if (segmentMatrices)
+    segments->rebuild(*newQc, unchanged);
+
+  qc              = std::move(newQc);
+  algorithm       = std::move(algo);
+  algorithmFormat = formatCode;
+  // the positions of the recorded steps refer to the previous circuit
+  profiler.clear();
+  if (gateFusion)
+    buildFusedBlocks();
+  for (auto& [start, block] : unchangedBlocks) {
+    const auto it = fusedBlocks.find(start);
+    if (it != fusedBlocks.end() && it->second.end == block.end)
+      it->second = block; // takes over the reference
+    else if (block.built)
+      dd->decRef(block.matrix);
+  }
+
+  irreversiblePositions.clear();
+  unsigned int opPosition = 0;
+  for (const auto& op : *qc) {
+    if (op->getType() == qc::Measure || op->getType() == qc::Reset)
+      irreversiblePositions.emplace_back(opPosition);
+    ++opPosition;
+  }
+}
+
+/**Tries to import the passed algorithm and throws if it is not valid.
+ * Additionally some operations/DDs can be applied or just the iterator advance
+ * forward without applying operations/DDs.
+ *
+ * @param algo the algorithm to import; it is kept by the engine, so callers
+ * that no longer need the text should move it in
+ * @param formatCode format of the algorithm (1 = QASM, 2 = Real)
+ * @param opNum number of operations to step forward (may be bigger than the
+ * number of operations the algorithm has)
+ * @param process whether the operations should be processed (new simulation)
+ * or just the iterator needs to be advanced (continue simulation)
+ */
+SimulationEngine::LoadResult SimulationEngine::load(std::string  algo,
+                                                    unsigned int formatCode,
+                                                    unsigned int opNum,
+                                                    const bool   process) {
+  LoadResult result{};
+
+  if (formatCode != 1 && formatCode != 2)
+    throw std::invalid_argument("Invalid format-code!");
+  // an unchanged text (e.g., an edit that was undone) keeps the loaded circuit
+  // and everything derived from it
+  if (!ready || algo != algorithm || formatCode != algorithmFormat)
+    replaceCircuit(std::move(algo), formatCode);
+
+  // re-initialize some variables (though depending on opNum they might change
+  // in the next lines)
+  ready     = true;
+  atInitial = true;
+  atEnd     = false;
+  iterator  = qc->begin();
+  position  = 0;
+  // resize the DD package so that it can hold as many variables
+  dd->resize(qc->getNqubits());
+  measurements.resize(qc->getNqubits());
+
+  result.numOfOperations = qc->getNops();
+
+  if (opNum > qc->getNops())
+    opNum = static_cast<unsigned int>(qc->getNops());
+  if (opNum > 0) {
+    atInitial = false;
+    if (process) {
+      if (sim.p == nullptr) {
+        sim = dd->makeZeroState(qc->getNqubits());
+        dd->incRef(sim);
+      }
+      // a fresh simulation may only reuse checkpoints that do not depend on
+      // previous measurement results
+      auto checkpointPos = closestCheckpoint(opNum);
+      if (irreversibleBetween(0, checkpointPos))
+        checkpointPos = 0;
+      restoreCheckpoint(checkpointPos);
+      atInitial = false;
+
+      while (position < opNum) { // apply the remaining operations
+        advance(opNum);
+      }
+      finishBatch();
+    } else {
+      for (unsigned int i = 0; i < opNum; i++) {
+        iterator++; // just advance the iterator so it points to the operations
+                    // where we stopped before the edit
+        position++;
+      }
+    }
+    result.nextIsIrreversible = nextIsIrreversible();
+    result.noGoingBack        = previousIsIrreversible();
+
+  } else { // sim needs to be initialized in some cases
+    if (sim.p != nullptr) {
+      dd->decRef(sim);
+    }
+    sim = dd->makeZeroState(qc->getNqubits());
+    dd->incRef(sim);
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Sets the iterator and position back to the very beginning.
+ * atInitial will be true and in most cases atEnd will be false (special case
+ * for empty algorithms: atEnd is also true) after this call.
+ *
+ * @return true if the DD changed, false otherwise (nothing was done or an error
+ * occurred)
+ */
+bool SimulationEngine::toStart() {
+  checkReady();
+  if (qc->empty() || atInitial)
+    return false; // nothing changed
+
+  try {
+    dd->decRef(sim);
+    sim = dd->makeZeroState(qc->getNqubits());
+    dd->incRef(sim);
+    atInitial = true;
+    atEnd = false; // now we are definitely not at the end (if there were no
+                   // operation, so atInitial and atEnd could be true at the
+                   // same time, if(qc1-empty)
+    // would already have returned
+    iterator = qc->begin();
+    position = 0;
+    std::fill(measurements.begin(), measurements.end(), false);
+
+    return true; // something changed
+
+  } catch (const std::exception& e) {
+    std::cout << "Exception while going back to the start!" << std::endl;
+    std::cout << e.what() << std::endl;
+    return false; // nothing changed
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Goes back to the previous step of the simulation process by applying the
+ * inverse of the last processed operation/DD. If atInitial is true, nothing
+ * happens instead. atEnd will be false (except when the last operation is
+ * irreversible). atInitial could end up being true, depending on the position.
+ */
+SimulationEngine::PrevResult SimulationEngine::prev() {
+  checkReady();
+  PrevResult result{};
+  if (qc->empty())
+    return result;
+
+  if (atEnd) {
+    atEnd = false;
+  } else if (atInitial) {
+    return result; // we can't go any further back
+  }
+
+  try {
+    stepBack(); // go back to the start before the last processed operation
+    result.changed     = true;
+    result.noGoingBack = previousIsIrreversible();
+  } catch (const std::exception& e) {
+    std::cout << "Exception while getting the current operation {src: prev}!"
+              << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Goes forward to the next step of the simulation process by applying the
+ * current operation/DD. If atEnd is true, nothing happens instead. atInitial
+ * will be false and atEnd could end up being true, depending on the position.
+ * Measurements and resets are not applied directly, instead their parameters
+ * are returned so the user can decide on the outcome.
+ */
+SimulationEngine::NextResult SimulationEngine::next() {
+  checkReady();
+  NextResult result{};
+  if (qc->empty())
+    return result;
+
+  if (atInitial) {
+    atInitial = false;
+  } else if (atEnd) {
+    return result; // we can't go any further ahead
+  }
+
+  try {
+    result.changed = true;
+
+    if ((*iterator)->getType() == qc::Reset ||
+        (*iterator)->getType() == qc::Measure) {
+      IrreversibleParameter parameter{};
+      const auto            qubits = (*iterator)->getTargets();
+      parameter.qubit              = static_cast<dd::Qubit>(qubits.front());
+      parameter.total              = qubits.size();
+      if ((*iterator)->getType() == qc::Measure) {
+        parameter.cbit =
+            dynamic_cast<qc::NonUnitaryOperation*>(iterator->get())
+                ->getClassics()
+                .front();
+      }
+      std::tie(parameter.pzero, parameter.pone) =
+          dd->determineMeasurementProbabilities(sim, parameter.qubit, true);
+      result.parameter                    = parameter;
+      result.conductIrreversibleOperation = true;
+
+      iterator++; // advance iterator
+      position++;
+      if (iterator ==
+          qc->end()) { // qc1->end() is after the last operation in the iterator
+        atEnd = true;
+      }
+      // the states after the measurement/reset depend on its outcome
+      invalidateCheckpoints(position);
+    } else {
+      stepForward(); // process the next operation
+    }
+
+    result.nextIsIrreversible = nextIsIrreversible();
+  } catch (const std::exception& e) {
+    std::cout << "Exception while getting the current operation {src: next}!"
+              << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Processes all operations until the iterator points to the very end, a barrier
+ * or an irreversible operation is reached.
+ */
+SimulationEngine::ToEndResult SimulationEngine::toEnd() {
+  checkReady();
+  ToEndResult result{};
+  if (qc->empty() || atEnd)
+    return result; // nothing changed
+
+  atInitial = false; // now we are definitely not at the beginning (if there
+                     // were no operation, so atInitial and atEnd could be
+                     // true at the same time, if(qc1-empty)
+  // would already have returned
+  try {
+    result.changed = true;
+    while (!atEnd) {
+      if ((*iterator)->getType() == qc::Measure ||
+          (*iterator)->getType() == qc::Reset) {
+        result.nextIsIrreversible = true;
+        break;
+      } else if ((*iterator)->getType() == qc::Barrier) {
+        ++result.nops;
+        stepForward(true); // process the barrier
+        result.barrier = true;
+        break;
+      } else {
+        result.nops += advance(static_cast<unsigned int>(qc->getNops()));
+      }
+    }
+    finishBatch();
+  } catch (const std::exception& e) {
+    std::cout << "Exception while going to the end!" << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+/**Depending on the current position of the iterator and the given parameter
+ * this function either applies inverse operations/DDs like Prev or
+ * operations/DDs normally like Next. atInitial and atEnd could be anything
+ * after this call.
+ *
+ * @param targetPos position the iterator should point at after this call
+ */
+SimulationEngine::ToLineResult
+SimulationEngine::toLine(unsigned int targetPos) {
+  ToLineResult result{};
+  if (targetPos > qc->getNops())
+    // we can't go further than to the end
+    targetPos = static_cast<unsigned int>(qc->getNops());
+
+  try {
+    result.noGoingBack        = previousIsIrreversible();
+    result.nextIsIrreversible = nextIsIrreversible();
+    if (position == targetPos)
+      return result; // nothing changed
+
+    // the target is either reached by stepping from the current position (only
+    // possible backwards if no irreversible operation lies in between) or by
+    // restoring the closest checkpoint before the target and replaying the
+    // remaining operations - whichever needs fewer operations
+    auto stepCost = std::numeric_limits<unsigned int>::max();
+    if (targetPos > position)
+      stepCost = targetPos - position;
+    else if (!irreversibleBetween(targetPos, position))
+      stepCost = position - targetPos;
+
+    const auto checkpointPos = closestCheckpoint(targetPos);
+    bool       useCheckpoint = targetPos - checkpointPos < stepCost;
+    if (useCheckpoint && targetPos > position) {
+      // jumping forward must not skip an irreversible operation that still
+      // needs to be conducted
+      useCheckpoint = checkpointPos > position &&
+                      !irreversibleBetween(position, checkpointPos);
+    }
+
+    if (useCheckpoint) {
+      // the client interprets nops as absolute position if reset is set
+      result.reset   = true;
+      result.changed = true;
+
+      restoreCheckpoint(checkpointPos);
+      result.nops               = position;
+      result.noGoingBack        = position == 0 || previousIsIrreversible();
+      result.nextIsIrreversible = nextIsIrreversible();
+    } else if (targetPos < position) {
+      result.noGoingBack = false;
+      while (position > targetPos) {
+        if (previousIsIrreversible()) {
+          result.noGoingBack = true;
+          break;
+        }
+        ++result.nops;
+        stepBack(true);
+        result.changed            = true;
+        result.nextIsIrreversible = false;
+      }
+    }
+
+    while (position < targetPos) {
+      if (nextIsIrreversible()) {
+        result.nextIsIrreversible = true;
+        break;
+      } else {
+        result.nops += advance(targetPos); // process the next operation(s)
+      }
+      result.changed     = true;
+      result.noGoingBack = false;
+    }
+    finishBatch();
+
+    atInitial = false;
+    atEnd     = false;
+    if (position == 0)
+      atInitial = true;
+    else if (position == qc->getNops())
+      atEnd = true;
+
+    return result; // something changed
+
+  } catch (const std::exception& e) {
+    std::stringstream ss{};
+    ss << "Exception while going from " << position << " to " << targetPos
+       << ": " << e.what() << "\n";
+    const auto msg = ss.str();
+    std::cout << msg << std::endl;
+    throw std::runtime_error(msg);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Creates a DD in the .dot-format for the current state of the simulation
+ * together with its amplitudes (empty if the state has too many qubits).
+ */
+SimulationEngine::ExportResult
+SimulationEngine::getDD(const AmplitudeOptions& options) const {
+  checkReady();
+  try {
+    auto result = getAmplitudes(options);
+    result.dot  = dotCache->get(sim, {showColors, showEdgeLabels, showClassic,
+                                      usePolarCoordinates});
+    return result;
+
+  } catch (const std::exception& e) {
+    std::stringstream sserr{};
+    sserr << "Exception while getting the DD: " << e.what() << "\n";
+    sserr << "The values of the Flags are: " << this->showColors << ", "
+          << this->showEdgeLabels << ", " << this->showClassic << ", "
+          << this->usePolarCoordinates << "\n";
+    throw std::runtime_error(sserr.str());
+  }
+}
+
+/**Exports only the amplitudes of the current state as getDD does, without
+ * creating the .dot-representation (dot stays empty).
+ */
+SimulationEngine::ExportResult
+SimulationEngine::getAmplitudes(const AmplitudeOptions& options) const {
+  checkReady();
+  ExportResult result{};
+  result.nqubits = qc->getNqubits();
+
+  switch (options.mode) {
+  case AmplitudeMode::Dense:
+    if (result.nqubits <=
+        std::min(options.limit, MAX_QUBITS_FOR_DENSE_AMPLITUDES)) {
+      result.amplitudes.resize(1ull << (qc->getNqubits() + 1));
+      calculateAmplitudes(result.amplitudes.data());
+    }
+    break;
+  case AmplitudeMode::Sparse:
+  case AmplitudeMode::TopK: {
+    result.sparse = true;
+    // the indices have to fit into 64 bit
+    if (result.nqubits >
+        static_cast<std::size_t>(std::numeric_limits<std::uint64_t>::digits))
+      break;
+    const auto limit = std::min(options.limit, MAX_AMPLITUDE_ENTRIES);
+    if (options.mode == AmplitudeMode::Sparse)
+      collectNonZeroAmplitudes(sim, result.nqubits, 0, 1., limit, result);
+    else
+      collectLargestAmplitudes(sim, result.nqubits, limit, result);
+    break;
+  }
+  }
+  return result;
+}
+
+/**Determines how the DD of the current state differs from the one exported by
+ * the previous call. Node ids stay the same as long as a node is part of the
+ * DD, so the client can patch its copy instead of re-rendering the complete
+ * DD.
+ *
+ * @param reset whether the client has no previous DD (e.g., after reloading),
+ * so the complete DD is reported as added
+ */
+SimulationEngine::GraphDiff SimulationEngine::getDDDiff(const bool reset) {
+  checkReady();
+  if (reset)
+    graph.clear();
+  return graph.update(sim);
+}
+
+/**Exports the DD of the current state as node and edge tables, honouring the
+ * export options (see GraphTables).
+ */
+GraphTables SimulationEngine::getGraph() const {
+  checkReady();
+  return exportGraph(sim, {showColors, showEdgeLabels, showClassic,
+                           usePolarCoordinates});
+}
+
+/**Writes the loaded algorithm, the current position, the measurement results,
+ * the export options and the current state to the stream (see sessionfile).
+ * Checkpoints and cached DDs are not saved.
+ */
+void SimulationEngine::save(std::ostream& os) const {
+  checkReady();
+  sessionfile::writeHeader(os, sessionfile::Kind::Simulation);
+  sessionfile::write<std::uint32_t>(os, algorithmFormat);
+  sessionfile::writeString(os, algorithm);
+  sessionfile::write<std::uint32_t>(os, position);
+  sessionfile::writeBits(os, measurements);
+
+  std::uint8_t options = 0;
+  if (showColors)
+    options |= sessionfile::COLORED;
+  if (showEdgeLabels)
+    options |= sessionfile::EDGE_LABELS;
+  if (showClassic)
+    options |= sessionfile::CLASSIC;
+  if (usePolarCoordinates)
+    options |= sessionfile::POLAR;
+  sessionfile::write(os, options);
+
+  dd::serialize(sim, os, true);
+  if (!os)
+    throw std::runtime_error("Could not write the session!");
+}
+
+/**Restores a session written by save: the algorithm is imported again, but the
+ * state at the saved position is read from the stream instead of being
+ * simulated. The session is only replaced once the complete file has been
+ * checked, so a corrupted file leaves the running session intact.
+ *
+ * @throws std::runtime_error if the stream does not contain a valid session
+ */
+SimulationEngine::RestoreResult SimulationEngine::restore(std::istream& is) {
+  sessionfile::readHeader(is, sessionfile::Kind::Simulation);
+  RestoreResult result{};
+  result.formatCode        = sessionfile::read<std::uint32_t>(is);
+  result.algo              = sessionfile::readString(is);
+  result.position          = sessionfile::read<std::uint32_t>(is);
+  auto       savedMeasures = sessionfile::readBits(is);
+  const auto options       = sessionfile::read<std::uint8_t>(is);
+
+  if (result.formatCode != 1 && result.formatCode != 2)
+    throw std::runtime_error("The saved session is inconsistent!");
+  const auto savedQc = CircuitCache::instance().import(
+      result.algo,
+      result.formatCode == 1 ? qc::Format::OpenQASM3 : qc::Format::Real);
+  const auto nqubits = savedQc->getNqubits();
+  if (result.position > savedQc->getNops() || savedMeasures.size() != nqubits)
+    throw std::runtime_error("The saved session is inconsistent!");
+
+  const bool hadPackage = hasPackage();
+  acquirePackage(nqubits);
+  dd::vEdge state{};
+  try {
+    state = sessionfile::readDD<dd::vNode>(is, *dd, nqubits);
+  } catch (...) {
+    if (!hadPackage)
+      releasePackage();
+    throw;
+  }
+
+  // the algorithm is valid and its import cached, so only now the loaded one
+  // is replaced
+  try {
+    result.load = load(result.algo, result.formatCode, 0, true);
+  } catch (...) {
+    dd->decRef(state);
+    throw;
+  }
+  dd->decRef(sim);
+  sim = state;
+  // the checkpoints of the import may belong to different measurement results
+  clearCheckpoints();
+  graph.clear();
+
+  measurements = std::move(savedMeasures);
+  iterator     = qc->begin() + result.position;
+  position     = result.position;
+  atInitial    = position == 0;
+  atEnd        = iterator == qc->end();
+
+  showColors          = (options & sessionfile::COLORED) != 0;
+  showEdgeLabels      = (options & sessionfile::EDGE_LABELS) != 0;
+  showClassic         = (options & sessionfile::CLASSIC) != 0;
+  usePolarCoordinates = (options & sessionfile::POLAR) != 0;
+
+  result.load.nextIsIrreversible = nextIsIrreversible();
+  result.load.noGoingBack        = previousIsIrreversible();
+  return result;
+}
+
+/**Updates the fields of this object that determine with which options the
+ * DD should be exported (on the next getDD-call).
+ */
+void SimulationEngine::updateExportOptions(const bool colors,
+                                           const bool edgeLabels,
+                                           const bool classic,
+                                           const bool polar) {
+  this->showColors          = colors;
+  this->showEdgeLabels      = edgeLabels;
+  this->showClassic         = classic;
+  this->usePolarCoordinates = polar;
+}
+
+/**Updates the options that determine which amplitudes are exported (on the
+ * next getDD-call without explicit options). The limit is capped at
+ * MAX_QUBITS_FOR_DENSE_AMPLITUDES or MAX_AMPLITUDE_ENTRIES, respectively.
+ */
+void SimulationEngine::updateAmplitudeOptions(const AmplitudeOptions& options) {
+  amplitudeOptions = options;
+  amplitudeOptions.limit =
+      std::min(options.limit, options.mode == AmplitudeMode::Dense
+                                  ? MAX_QUBITS_FOR_DENSE_AMPLITUDES
+                                  : MAX_AMPLITUDE_ENTRIES);
+}
+
+SimulationEngine::AmplitudeOptions
+SimulationEngine::defaultAmplitudeOptions(const AmplitudeMode mode) {
+  if (mode == AmplitudeMode::Dense)
+    return {mode, MAX_QUBITS_FOR_AMPLITUDES};
+  return {mode, DEFAULT_AMPLITUDE_ENTRIES};
+}
+
+/**Conducts one step of a measurement or reset with the outcome chosen by the
+ * user and determines the parameters of the next qubit to measure/reset.
+ *
+ * @param cbit classical bit the result is stored in (not set for resets)
+ * @throws std::invalid_argument if the remaining qubits (or classical bits)
+ * of the operation do not exist
+ */
+SimulationEngine::ConductResult SimulationEngine::conductIrreversibleOperation(
+    dd::Qubit qubit, dd::fp pzero, dd::fp pone,
+    const std::string& classicalValueToMeasure, std::int64_t count,
+    const std::int64_t total, std::optional<std::size_t> cbit) {
+  checkReady();
+  // the remaining qubits are conducted one after another, starting at qubit,
+  // and their results go to consecutive classical bits
+  const auto first     = static_cast<std::int64_t>(qubit);
+  const auto remaining = total - count;
+  if (count < 0 || remaining <= 0 || first < 0 ||
+      first + remaining > static_cast<std::int64_t>(qc->getNqubits()))
+    throw std::invalid_argument("Invalid qubit of the irreversible operation!");
+  if (cbit.has_value() &&
+      (*cbit > measurements.size() ||
+       static_cast<std::size_t>(remaining) > measurements.size() - *cbit))
+    throw std::invalid_argument(
+        "Invalid classical bit of the irreversible operation!");
+
+  ConductResult result{};
+
+  if (!cbit.has_value()) {
+    // reset operation
+    if (classicalValueToMeasure == "0") {
+      dd->performCollapsingMeasurement(sim, qubit, pzero, true);
+    } else if (classicalValueToMeasure == "1") {
+      dd->performCollapsingMeasurement(sim, qubit, pone, false);
+      // apply x operation to reset to |0>
+      const auto x   = qc::StandardOperation(qubit, qc::X);
+      auto       tmp = dd->multiply(dd::getDD(&x, *dd), sim);
+      dd->incRef(tmp);
+      dd->decRef(sim);
+      sim = tmp;
+
+      dd->garbageCollect();
+    } else {
+      // do something in case operation is cancelled
+    }
+  } else {
+    // get target classical bit
+    if (classicalValueToMeasure != "none") {
+      const bool measureZero = (classicalValueToMeasure == "0");
+      dd->performCollapsingMeasurement(sim, qubit, measureZero ? pzero : pone,
+                                       measureZero);
+      measurements[*cbit] = !measureZero;
+    }
+    cbit = *cbit + 1;
+  }
+
+  count++;
+  if (count == total) {
+    // allows jumping back to this point without replaying the whole prefix
+    storeCheckpoint(true);
+    result.finished = true;
+    return result;
+  }
+
+  // next qubit
+  qubit++;
+  std::tie(pzero, pone) =
+      dd->determineMeasurementProbabilities(sim, qubit, true);
+
+  IrreversibleParameter parameter{};
+  parameter.qubit = qubit;
+  parameter.pzero = pzero;
+  parameter.pone  = pone;
+  parameter.cbit  = cbit;
+  parameter.count = static_cast<std::size_t>(count);
+  parameter.total = static_cast<std::size_t>(total);
+  result.parameter = parameter;
+  return result;
+}
@@ -0,0 +1,312 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include "DotCache.h"
+#include "EngineLock.h"
+#include "GraphExport.h"
+#include "OperationCache.h"
+#include "PackagePool.h"
+#include "Profiler.h"
+#include "SegmentCache.h"
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**Holds the state of a simulation session and implements all stepping and
+ * export logic of QDDVis without depending on N-API, so it can be driven from
+ * worker threads. Callers have to hold the lock returned by lock() (or an
+ * owning one returned by tryLock()) while calling any other method.
+ */
+class SimulationEngine {
+public:
+  // default limits for the amplitude export (number of qubits for dense
+  // vectors, number of entries for sparse/top-k exports) and their maxima
+  static constexpr unsigned short MAX_QUBITS_FOR_AMPLITUDES       = 9;
+  static constexpr std::size_t    MAX_QUBITS_FOR_DENSE_AMPLITUDES = 20;
+  static constexpr std::size_t    DEFAULT_AMPLITUDE_ENTRIES       = 1024;
+  static constexpr std::size_t    MAX_AMPLITUDE_ENTRIES           = 1U << 16U;
+  // initial number of operations between two checkpoints (doubled whenever
+  // the checkpoints exceed their node budget)
+  static constexpr unsigned int CHECKPOINT_INTERVAL = 64;
+  // upper bound on the summed node count of all stored checkpoints
+  static constexpr std::size_t MAX_CHECKPOINT_NODES = 1U << 20U;
+  // number of operations a multi-step move (toEnd, toLine, load) applies
+  // before the package gets the chance to collect garbage
+  static constexpr unsigned int BATCH_GC_INTERVAL = 32;
+  // limits for the blocks of operations that are fused into a single DD
+  static constexpr unsigned int MAX_FUSED_OPERATIONS = 16;
+  static constexpr std::size_t  MAX_FUSED_QUBITS     = 3;
+
+  // parameters of a pending measurement or reset the user has to decide on
+  struct IrreversibleParameter {
+    dd::Qubit                  qubit = 0;
+    dd::fp                     pzero = 0.;
+    dd::fp                     pone  = 0.;
+    std::optional<std::size_t> cbit{}; // only set for measurements
+    std::size_t                count = 0;
+    std::size_t                total = 0;
+  };
+
+  struct LoadResult {
+    std::size_t numOfOperations    = 0;
+    bool        nextIsIrreversible = false;
+    bool        noGoingBack        = false;
+  };
+  struct RestoreResult {
+    LoadResult   load{};
+    std::string  algo{}; // the algorithm the session had loaded
+    unsigned int formatCode = 0;
+    unsigned int position   = 0;
+  };
+  struct PrevResult {
+    bool changed     = false;
+    bool noGoingBack = false;
+  };
+  struct NextResult {
+    bool changed                      = false;
+    bool conductIrreversibleOperation = false;
+    bool nextIsIrreversible           = false;
+    std::optional<IrreversibleParameter> parameter{};
+  };
+  struct ToEndResult {
+    bool               changed            = false;
+    bool               nextIsIrreversible = false;
+    bool               barrier            = false;
+    unsigned long long nops               = 0;
+  };
+  struct ToLineResult {
+    bool               changed            = false;
+    bool               noGoingBack        = false;
+    bool               nextIsIrreversible = false;
+    bool               reset              = false;
+    unsigned long long nops               = 0;
+  };
+  struct ConductResult {
+    bool                                 finished = false;
+    std::optional<IrreversibleParameter> parameter{};
+  };
+  enum class AmplitudeMode {
+    Dense,  // all amplitudes, if the state has at most limit qubits
+    Sparse, // the first limit nonzero amplitudes (by index)
+    TopK    // the limit amplitudes with the largest magnitude
+  };
+  struct AmplitudeOptions {
+    AmplitudeMode mode  = AmplitudeMode::Dense;
+    std::size_t   limit = MAX_QUBITS_FOR_AMPLITUDES;
+  };
+  struct ExportResult {
+    std::string dot{};
+    std::size_t nqubits = 0;
+    bool        sparse  = false; // whether indices holds the basis states
+    // real and imaginary part alternating; dense: empty if the state has too
+    // many qubits
+    std::vector<float>         amplitudes{};
+    std::vector<std::uint64_t> indices{}; // sorted
+  };
+
+  using GraphDiff = GraphModel<dd::vNode>::Diff;
+
+  SimulationEngine();
+  ~SimulationEngine();
+
+  SimulationEngine(const SimulationEngine&)            = delete;
+  SimulationEngine& operator=(const SimulationEngine&) = delete;
+
+  using Lock = EngineLock<SimulationEngine>;
+
+  // blocks until the engine is idle, so it is meant for worker threads; the
+  // memory usage is measured when the lock is released
+  [[nodiscard]] Lock lock() { return Lock{*this, mutex}; }
+  // does not block; the returned lock does not own the mutex if it is busy
+  [[nodiscard]] std::unique_lock<std::mutex> tryLock() {
+    return std::unique_lock{mutex, std::try_to_lock};
+  }
+
+  LoadResult    load(std::string algo, unsigned int formatCode,
+                     unsigned int opNum, bool process);
+  bool          toStart();
+  PrevResult    prev();
+  NextResult    next();
+  ToEndResult   toEnd();
+  ToLineResult  toLine(unsigned int targetPos);
+  ExportResult  getDD() const { return getDD(amplitudeOptions); }
+  ExportResult  getDD(const AmplitudeOptions& options) const;
+  ExportResult  getAmplitudes() const {
+    return getAmplitudes(amplitudeOptions);
+  }
+  ExportResult  getAmplitudes(const AmplitudeOptions& options) const;
+  GraphDiff     getDDDiff(bool reset);
+  GraphTables   getGraph() const;
+  ConductResult conductIrreversibleOperation(
+      dd::Qubit qubit, dd::fp pzero, dd::fp pone,
+      const std::string& classicalValueToMeasure, std::int64_t count,
+      std::int64_t total, std::optional<std::size_t> cbit);
+  void          save(std::ostream& os) const;
+  RestoreResult restore(std::istream& is);
+
+  void updateExportOptions(bool colors, bool edgeLabels, bool classic,
+                           bool polar);
+  [[nodiscard]] bool getShowColors() const { return showColors; }
+  [[nodiscard]] bool getShowEdgeLabels() const { return showEdgeLabels; }
+  [[nodiscard]] bool getShowClassic() const { return showClassic; }
+  [[nodiscard]] bool getUsePolarCoordinates() const {
+    return usePolarCoordinates;
+  }
+
+  void updateAmplitudeOptions(const AmplitudeOptions& options);
+  [[nodiscard]] const AmplitudeOptions& getAmplitudeOptions() const {
+    return amplitudeOptions;
+  }
+  static AmplitudeOptions defaultAmplitudeOptions(AmplitudeMode mode);
+
+  void               setGateFusion(bool enabled);
+  [[nodiscard]] bool getGateFusion() const { return gateFusion; }
+
+  void               setSegmentMatrices(bool enabled);
+  [[nodiscard]] bool getSegmentMatrices() const { return segmentMatrices; }
+  bool               prepareSegment();
+
+  void               setProfiling(bool enabled);
+  [[nodiscard]] bool getProfiling() const { return profiler.isEnabled(); }
+  // statistics of the steps recorded while profiling was enabled (JSON)
+  [[nodiscard]] std::string getStats() const { return profiler.toJson(); }
+
+  [[nodiscard]] bool isReady() const { return ready; }
+  void               unready() { ready = false; }
+
+  [[nodiscard]] MemoryUsage memoryUsage() const;
+  // usage measured by the last operation; does not require the lock
+  [[nodiscard]] MemoryUsage cachedMemoryUsage() const;
+  [[nodiscard]] bool        hasPackage() const { return dd != nullptr; }
+  void                      releasePackage();
+  // size of the buffer of an algorithm that is streamed to the engine, which
+  // is added to cachedMemoryUsage; does not require the lock
+  void setStreamedBytes(std::size_t bytes) { streamedBytes = bytes; }
+
+private:
+  friend Lock;
+  void finishOperation();
+
+  // snapshot of the simulation state after the first `position` operations
+  struct Checkpoint {
+    qc::VectorDD      state{};
+    std::vector<bool> measurements{};
+    std::size_t       nodes  = 0;
+    bool              pinned = false; // stored after an irreversible operation
+  };
+
+  // run of adjacent operations that is applied as one DD by multi-step moves
+  struct FusedBlock {
+    unsigned int end = 0;  // position after the last operation of the block
+    qc::MatrixDD matrix{}; // built on first use
+    // the identity has no node, so the edge cannot tell whether it is built
+    bool built = false;
+  };
+
+  void stepForward(bool batched = false);
+  void stepBack(bool batched = false);
+  unsigned int advance(unsigned int limit);
+  unsigned int jump(unsigned int end, const qc::MatrixDD& matrix,
+                    Profiler::Measurement& measurement);
+  Profiler::Measurement measureJump(unsigned int end);
+  void collectGarbage(bool batched);
+  void finishBatch();
+  void calculateAmplitudes(float* amplitudes) const;
+  void checkReady() const;
+  [[nodiscard]] bool nextIsIrreversible() const;
+  [[nodiscard]] bool previousIsIrreversible() const;
+
+  void         storeCheckpoint(bool pinned = false);
+  void         invalidateCheckpoints(unsigned int from);
+  void         clearCheckpoints();
+  void         thinOutCheckpoints();
+  unsigned int closestCheckpoint(unsigned int targetPos) const;
+  void         restoreCheckpoint(unsigned int checkpointPos);
+  bool irreversibleBetween(unsigned int from, unsigned int to) const;
+
+  static bool isFusable(const qc::Operation& op);
+  void        buildFusedBlocks();
+  void        clearFusedBlocks();
+  void        acquirePackage(std::size_t nqubits);
+  void        replaceCircuit(std::string algo, unsigned int formatCode);
+
+  // serializes all accesses to the DD package
+  std::mutex mutex;
+  // memory usage measured at the end of the last operation
+  std::atomic<std::size_t> usageNodes{0};
+  std::atomic<std::size_t> usageBytes{0};
+  std::atomic<std::size_t> streamedBytes{0};
+
+  // fields
+  // taken from the PackagePool on the first load
+  PackagePool::PackagePtr                 dd;
+  std::unique_ptr<OperationCache>         opCache;
+  std::unique_ptr<SegmentCache>           segments;
+  std::unique_ptr<DotCache<dd::vNode>>    dotCache; // used by the const getDD
+  std::unique_ptr<qc::QuantumComputation> qc;
+  qc::VectorDD                            sim{};
+  // source of qc, kept for saving the session
+  std::string  algorithm{};
+  unsigned int algorithmFormat = 0;
+
+  std::vector<std::unique_ptr<qc::Operation>>::iterator iterator{};
+  unsigned int position = 0; // current position of the iterator
+  // operations applied by the current batch since the last garbage collection
+  unsigned int uncollectedSteps = 0;
+
+  std::vector<bool> measurements{};
+  // positions of all measurements and resets in the loaded circuit (sorted)
+  std::vector<unsigned int> irreversiblePositions{};
+
+  std::map<unsigned int, Checkpoint> checkpoints{};
+  std::size_t                        checkpointNodes    = 0;
+  unsigned int                       checkpointInterval = CHECKPOINT_INTERVAL;
+
+  bool gateFusion = false; // whether multi-step moves apply fused blocks
+  // fused blocks by the position of their first operation
+  std::map<unsigned int, FusedBlock> fusedBlocks{};
+
+  // whether multi-step moves apply the functionality DDs of whole segments
+  // (built in the background by prepareSegment)
+  bool segmentMatrices = false;
+
+  // records the durations of the single steps if enabled
+  Profiler profiler{};
+
+  bool ready = false; // true if a valid algorithm is imported, false otherwise
+  bool atInitial =
+      true; // whether we currently visualize the initial state or not
+  bool atEnd =
+      false; // whether we currently visualize the end of the given circuit
+
+  // options for the DD export
+  bool showColors          = true;
+  bool showEdgeLabels      = true;
+  bool showClassic         = false;
+  bool usePolarCoordinates = true;
+
+  // options for the amplitude export
+  AmplitudeOptions amplitudeOptions{};
+
+  // nodes of the DD the client has received via getDDDiff
+  GraphModel<dd::vNode> graph{};
+};
+
+#endif
@@ -0,0 +1,1558 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "VerificationEngine.h"
+
+#include "CircuitCache.h"
+#include "SessionFile.h"
+#include "dd/Export.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+/**Checks whether a matrix DD is a multiple of the identity, ignoring the
+ * inputs with an ancillary qubit set to one (the initial functionality maps
+ * those to zero). Every node is examined at most once and the check of a node
+ * stops at the first successor that rules out the identity.
+ */
+class IdentityCheck {
+public:
+  using Factor = std::optional<std::complex<dd::fp>>;
+
+  IdentityCheck(const std::vector<bool>& ancillary, const dd::fp tolerance)
+      : ancillary(ancillary), tolerance(tolerance) {}
+
+  /**
+   * @return f if the DD rooted at e is f times the identity, nothing otherwise
+   */
+  Factor factor(const qc::MatrixDD& e) {
+    const auto w = static_cast<std::complex<dd::fp>>(e.w);
+    if (isZero(w))
+      return std::complex<dd::fp>{};
+    // skipped levels and the terminal stand for the identity
+    if (e.isTerminal())
+      return w;
+    const auto f = nodeFactor(e.p);
+    if (!f.has_value())
+      return std::nullopt;
+    return w * *f;
+  }
+
+  /**Finds an input basis state that is not mapped to (a multiple of) itself,
+   * or, if every basis state is, one that gets a different factor than the
+   * all-zero state.
+   *
+   * @return the basis state with qubit 0 as rightmost character
+   */
+  std::string counterexample(const qc::MatrixDD& root,
+                             const std::size_t   nqubits) {
+    std::string bits(nqubits, '0');
+    if (!isZero(static_cast<std::complex<dd::fp>>(root.w)) &&
+        !root.isTerminal() && !nodeFactor(root.p).has_value())
+      locate(root.p, bits);
+    return bits;
+  }
+
+private:
+  [[nodiscard]] bool isZero(const std::complex<dd::fp>& w) const {
+    return std::abs(w) <= tolerance;
+  }
+  [[nodiscard]] bool isZero(const qc::MatrixDD& e) const {
+    return isZero(static_cast<std::complex<dd::fp>>(e.w));
+  }
+  [[nodiscard]] bool isAncillary(const dd::Qubit qubit) const {
+    return static_cast<std::size_t>(qubit) < ancillary.size() &&
+           ancillary[static_cast<std::size_t>(qubit)];
+  }
+  static void setBit(std::string& bits, const dd::Qubit qubit,
+                     const bool value) {
+    bits[bits.size() - 1 - static_cast<std::size_t>(qubit)] =
+        value ? '1' : '0';
+  }
+
+  Factor nodeFactor(const dd::mNode* p) {
+    if (const auto it = memo.find(p); it != memo.end())
+      return it->second;
+
+    // successors: 0 = (row 0, column 0), 1 = (0, 1), 2 = (1, 0), 3 = (1, 1)
+    const auto& e = p->e;
+    Factor      f{};
+    if (isZero(e[2]) && (isAncillary(p->v) || isZero(e[1]))) {
+      f = factor(e[0]);
+      if (f.has_value() && !isAncillary(p->v)) {
+        const auto f3 = factor(e[3]);
+        if (!f3.has_value() || std::abs(*f - *f3) > tolerance)
+          f = std::nullopt;
+      }
+    }
+    memo.emplace(p, f);
+    return f;
+  }
+
+  /**Descends from a node that is not a multiple of the identity to the first
+   * deviation and sets the input bits on the way.
+   */
+  void locate(const dd::mNode* p, std::string& bits) {
+    const auto& e = p->e;
+    // an off-diagonal block maps an input to a different output
+    if (!isZero(e[2]) || (!isAncillary(p->v) && !isZero(e[1]))) {
+      const auto column = isZero(e[2]) ? 1 : 2;
+      setBit(bits, p->v, column == 1);
+      anyColumn(e[column], bits);
+      return;
+    }
+    const auto f0 = factor(e[0]);
+    if (!f0.has_value()) {
+      locate(e[0].p, bits);
+      return;
+    }
+    setBit(bits, p->v, true);
+    // otherwise, the inputs with this qubit set to one get a different factor
+    if (!factor(e[3]).has_value())
+      locate(e[3].p, bits);
+  }
+
+  /**Sets the remaining input bits to a column with a nonzero entry.
+   */
+  void anyColumn(const qc::MatrixDD& e, std::string& bits) {
+    if (e.isTerminal())
+      return;
+    for (std::size_t i = 0; i < e.p->e.size(); ++i) {
+      if (!isZero(e.p->e[i])) {
+        setBit(bits, e.p->v, (i & 1U) != 0);
+        anyColumn(e.p->e[i], bits);
+        return;
+      }
+    }
+  }
+
+  const std::vector<bool>&                     ancillary;
+  dd::fp                                       tolerance;
+  std::unordered_map<const dd::mNode*, Factor> memo{};
+};
+
+/**
+ * @return true if all operations of the circuit from the given position on are
+ * unitary, i.e., they can be part of a functionality
+ */
+bool unitaryFrom(const qc::QuantumComputation& qc, const std::size_t position) {
+  return std::all_of(qc.begin() + static_cast<std::ptrdiff_t>(position),
+                     qc.end(), [](const auto& op) { return op->isUnitary(); });
+}
+
+/**Builds the functionality of the operations of the circuit from the given
+ * position on and writes it to the stream (binary). If inverse is set, the
+ * inverse functionality is built instead.
+ */
+void serializeFunctionality(const qc::QuantumComputation& qc,
+                            const std::size_t position, const bool inverse,
+                            dd::Package<>& dd, std::ostream& os) {
+  auto functionality = dd.makeIdent();
+  dd.incRef(functionality);
+  for (auto it = qc.begin() + static_cast<std::ptrdiff_t>(position);
+       it != qc.end(); ++it) {
+    // the inverse is built in the order the operations are applied to algo2,
+    // i.e., from the right
+    const auto next =
+        inverse ? dd.multiply(functionality, dd::getInverseDD(it->get(), dd))
+                : dd.multiply(dd::getDD(it->get(), dd), functionality);
+    dd.incRef(next);
+    dd.decRef(functionality);
+    functionality = next;
+    dd.garbageCollect();
+  }
+  dd::serialize(functionality, os, true);
+  dd.decRef(functionality);
+}
+
+/**Applies all operations of the circuit to the given state. The state is
+ * referenced on return.
+ */
+qc::VectorDD applyCircuit(const qc::QuantumComputation& qc,
+                          qc::VectorDD state, dd::Package<>& dd) {
+  dd.incRef(state);
+  for (const auto& op : qc) {
+    auto next = dd.multiply(dd::getDD(op.get(), dd), state);
+    dd.incRef(next);
+    dd.decRef(state);
+    state = next;
+    dd.garbageCollect();
+  }
+  return state;
+}
+} // namespace
+
+VerificationEngine::VerificationEngine() {
+  this->qc1       = std::make_unique<qc::QuantumComputation>();
+  this->iterator1 = this->qc1->begin();
+  this->position1 = 0;
+
+  this->qc2       = std::make_unique<qc::QuantumComputation>();
+  this->iterator2 = this->qc2->begin();
+  this->position2 = 0;
+}
+
+VerificationEngine::~VerificationEngine() { releasePackage(); }
+
+/**Takes a DD package from the pool, unless the session already has one (see
+ * SimulationEngine::acquirePackage).
+ */
+void VerificationEngine::acquirePackage(const std::size_t nqubits) {
+  if (dd)
+    return;
+  dd       = PackagePool::instance().acquire(nqubits, this);
+  opCache = std::make_unique<OperationCache>(*dd);
+  // qc2 is applied inversely, but both directions are needed for each circuit
+  segments1 = std::make_unique<SegmentCache>(*dd, true);
+  segments2 = std::make_unique<SegmentCache>(*dd, true);
+  dotCache  = std::make_unique<DotCache<dd::mNode>>(*dd);
+}
+
+/**Drops both loaded circuits together with all DDs of the session and returns
+ * the package to the pool right away (see SimulationEngine::releasePackage).
+ */
+void VerificationEngine::releasePackage() {
+  if (!dd)
+    return;
+  if (sim.p != nullptr) {
+    dd->decRef(sim);
+    sim = {};
+  }
+  // the caches reference nodes of the package, so they go first
+  opCache.reset();
+  segments1.reset();
+  segments2.reset();
+  dotCache.reset();
+  PackagePool::instance().release(std::move(dd));
+
+  qc1        = std::make_unique<qc::QuantumComputation>();
+  iterator1  = qc1->begin();
+  position1  = 0;
+  ready1     = false;
+  atInitial1 = true;
+  atEnd1     = false;
+
+  qc2        = std::make_unique<qc::QuantumComputation>();
+  iterator2  = qc2->begin();
+  position2  = 0;
+  ready2     = false;
+  atInitial2 = true;
+  atEnd2     = false;
+}
+
+/**Counts the nodes of the DDs the session references: the current
+ * functionality, the segments, the cached operation DDs and the DDs whose DOT
+ * strings are cached (the strings are part of the bytes, just like the texts of
+ * the loaded algorithms).
+ */
+MemoryUsage VerificationEngine::memoryUsage() const {
+  MemoryUsage usage{};
+  if (!dd)
+    return usage;
+
+  usage.nodes = opCache->nodes() + segments1->nodes() + segments2->nodes() +
+                dotCache->nodes();
+  if (sim.p != nullptr)
+    usage.nodes += sim.size();
+  usage.bytes = usage.nodes * sizeof(dd::mNode) + dotCache->bytes() +
+                algorithm1.capacity() + algorithm2.capacity();
+  return usage;
+}
+
+MemoryUsage VerificationEngine::cachedMemoryUsage() const {
+  return {usageNodes.load(), usageBytes.load() + streamedBytes.load()};
+}
+
+/**Measures the memory usage for cachedMemoryUsage. Called by Lock before it
+ * releases the engine.
+ */
+void VerificationEngine::finishOperation() {
+  const auto usage = memoryUsage();
+  usageNodes       = usage.nodes;
+  usageBytes       = usage.bytes;
+}
+
+/**Applies the current operation/DD (determined by iterator) and increments both
+ * iterator and position. If iterator reaches its end, atEnd will be set to
+ * true.
+ *
+ * @param algo1 decides whether the function should be applied to algo1 or
+ * algo2.
+ * @param batched whether the step is part of a multi-step move, in which case
+ * garbage collection is deferred (see collectGarbage)
+ */
+void VerificationEngine::stepForward(bool algo1, const bool batched) {
+  if (algo1) {
+    if (atEnd1)
+      return; // no further steps possible
+    auto       measurement = measure(true, position1, 1, false);
+    const auto currDD      = opCache->get(
+        iterator1->get(), false); // retrieve the "new" current operation
+    measurement.lap(&Profiler::Sample::getDD);
+
+    auto temp = dd->multiply(
+        currDD, sim); // process the current operation by multiplying it with
+                      // the previous simulation-state
+    dd->incRef(temp);
+    dd->decRef(sim);
+    sim = temp;
+    measurement.lap(&Profiler::Sample::multiply);
+    collectGarbage(batched);
+    measurement.lap(&Profiler::Sample::garbageCollect);
+    measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+    iterator1++; // advance iterator
+    position1++;
+    // qc1->end() is after the last operation in the iterator
+    if (iterator1 == qc1->end())
+      atEnd1 = true;
+
+  } else {
+    if (atEnd2)
+      return; // no further steps possible
+    auto       measurement = measure(false, position2, 1, false);
+    const auto currDD      = opCache->get(
+        iterator2->get(),
+        true); // retrieve the inverse of the "new" current operation
+    measurement.lap(&Profiler::Sample::getDD);
+
+    auto temp = dd->multiply(
+        sim, currDD); // process the current operation by multiplying it with
+                      // the previous simulation-state
+    dd->incRef(temp);
+    dd->decRef(sim);
+    sim = temp;
+    measurement.lap(&Profiler::Sample::multiply);
+    collectGarbage(batched);
+    measurement.lap(&Profiler::Sample::garbageCollect);
+    measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+    iterator2++; // advance iterator
+    position2++;
+    // qc2->end() is after the last operation in the iterator
+    if (iterator2 == qc2->end())
+      atEnd2 = true;
+  }
+}
+
+/**Computes the products of the current functionality with the next operation
+ * of either algorithm and keeps the one with fewer nodes as a step of a
+ * multi-step move. The other product is dropped, so each candidate is
+ * multiplied exactly once. Both algorithms must have operations left.
+ *
+ * @return true if the operation of algo1 was applied, false if the one of algo2
+ */
+bool VerificationEngine::stepLookahead() {
+  auto       measurement = measure(true, position1, 1, false);
+  const auto currDD1     = opCache->get(iterator1->get(), false);
+  const auto currDD2     = opCache->get(iterator2->get(), true);
+  measurement.lap(&Profiler::Sample::getDD);
+
+  const auto left  = dd->multiply(currDD1, sim);
+  const auto right = dd->multiply(sim, currDD2);
+  const bool algo1 = left.size() <= right.size();
+  const auto temp  = algo1 ? left : right;
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(true);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  if (!algo1)
+    measurement.attribute(false, position2, (*iterator2)->getType());
+  measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+  if (algo1) {
+    ++iterator1;
+    ++position1;
+    if (iterator1 == qc1->end())
+      atEnd1 = true;
+  } else {
+    ++iterator2;
+    ++position2;
+    if (iterator2 == qc2->end())
+      atEnd2 = true;
+  }
+  return algo1;
+}
+
+/**If either atInitial is true or the iterator is at the beginning, this method
+ * does nothing. In other cases it will first decrement both position and
+ * iterator before applying the inverse of the operation/DD the iterator is then
+ * pointing at.
+ *
+ * @param algo1 decides whether the function should be applied to algo1 or
+ * algo2.
+ * @param batched whether the step is part of a multi-step move, in which case
+ * garbage collection is deferred (see collectGarbage)
+ */
+void VerificationEngine::stepBack(bool algo1, const bool batched) {
+  if (algo1) {
+    if (atInitial1)
+      return; // no step back possible
+
+    if (iterator1 == qc1->begin()) {
+      atInitial1 = true;
+      return;
+    }
+
+    iterator1--; // set iterator back to the desired operation
+    position1--;
+
+    auto       measurement = measure(true, position1, 1, true);
+    const auto currDD      = opCache->get(
+        iterator1->get(), true); // get the inverse of the current operation
+    measurement.lap(&Profiler::Sample::getDD);
+
+    auto temp = dd->multiply(
+        currDD,
+        sim); //"remove" the current operation by multiplying with its inverse
+    dd->incRef(temp);
+    dd->decRef(sim);
+    sim = temp;
+    measurement.lap(&Profiler::Sample::multiply);
+    collectGarbage(batched);
+    measurement.lap(&Profiler::Sample::garbageCollect);
+    measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+  } else {
+    if (atInitial2)
+      return; // no step back possible
+
+    if (iterator2 == qc2->begin()) {
+      atInitial2 = true;
+      return;
+    }
+
+    iterator2--; // set iterator back to the desired operation
+    position2--;
+
+    auto       measurement = measure(false, position2, 1, true);
+    const auto currDD      = opCache->get(iterator2->get(),
+                                          false); // get the current operation
+    measurement.lap(&Profiler::Sample::getDD);
+
+    auto temp = dd->multiply(sim, currDD); //"remove" the current operation by
+                                           // multiplying with its inverse
+    dd->incRef(temp);
+    dd->decRef(sim);
+    sim = temp;
+    measurement.lap(&Profiler::Sample::multiply);
+    collectGarbage(batched);
+    measurement.lap(&Profiler::Sample::garbageCollect);
+    measurement.finish(dd->matrixMatrixMultiplication, sim);
+  }
+}
+
+/**Removes all applied operations, either by taking steps back or by
+ * rebuilding the functionality without them (see seek). atInitial will be true
+ * and in most cases atEnd will be false (special case for empty algorithms:
+ * atEnd is also true) after this call.
+ *
+ * @param algo1 decides whether the function should be applied to algo1 or
+ * algo2.
+ */
+void VerificationEngine::stepToStart(bool algo1) {
+  seek(algo1, 0);
+  (algo1 ? atInitial1 : atInitial2) = true;
+}
+
+/**Counts the multiplications needed to go from one position of algo1 or algo2
+ * to another, taking the segments whose functionality DDs are built into
+ * account.
+ */
+unsigned int VerificationEngine::multiplications(const bool         algo1,
+                                                 const unsigned int from,
+                                                 const unsigned int to) const {
+  if (!segmentMatrices)
+    return from < to ? to - from : from - to;
+
+  const auto&  segments = algo1 ? segments1 : segments2;
+  unsigned int count    = 0;
+  for (auto position = from; position < to; ++count) {
+    const auto* segment = segments->forward(position, to);
+    position            = segment != nullptr ? segment->end : position + 1;
+  }
+  for (auto position = from; position > to; ++count) {
+    const auto* segment = segments->backward(position, to);
+    position            = segment != nullptr ? segment->start : position - 1;
+  }
+  return count;
+}
+
+/**Moves algo1 or algo2 to the target position as part of a multi-step move.
+ * Going back operation by operation costs as many multiplications as going
+ * forward, so if the target lies closer to the start than the current
+ * position is to the target, the functionality is rebuilt from the initial one
+ * instead, i.e., only the prefixes of both algorithms are applied again.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ * @param targetPos position of algo1 or algo2 after this call (at most the
+ * number of operations)
+ */
+void VerificationEngine::seek(const bool algo1, const unsigned int targetPos) {
+  auto&      position      = algo1 ? position1 : position2;
+  const auto otherPosition = algo1 ? position2 : position1;
+  // the operations of an algorithm that is not ready cannot be applied again
+  const bool canRebuild = (algo1 ? ready2 : ready1) || otherPosition == 0;
+
+  const auto stepCost    = multiplications(algo1, position, targetPos);
+  const auto rebuildCost = multiplications(algo1, 0, targetPos) +
+                           multiplications(!algo1, 0, otherPosition);
+  if (canRebuild && rebuildCost < stepCost) {
+    rebuild(algo1, targetPos);
+  } else {
+    // only one of the two loops can be entered
+    while (position > targetPos)
+      retreat(algo1, targetPos);
+    while (position < targetPos)
+      advance(algo1, targetPos);
+  }
+  finishBatch();
+}
+
+/**Replaces the functionality with the initial one and applies the operations
+ * of algo1 or algo2 up to the target position as well as the operations of
+ * the other algorithm up to its current position again. atInitial and atEnd of
+ * the moved algorithm are up to the caller.
+ */
+void VerificationEngine::rebuild(const bool         algo1,
+                                 const unsigned int targetPos) {
+  dd->decRef(sim);
+  sim = dd->createInitialMatrix(initialAncillary);
+  dd->incRef(sim);
+
+  auto&      otherIterator = algo1 ? iterator2 : iterator1;
+  auto&      otherPosition = algo1 ? position2 : position1;
+  auto&      otherAtEnd    = algo1 ? atEnd2 : atEnd1;
+  const auto otherTarget   = otherPosition;
+  const bool wasAtEnd      = otherAtEnd;
+  otherIterator            = (algo1 ? qc2 : qc1)->begin();
+  otherPosition            = 0;
+  otherAtEnd               = false;
+  while (otherPosition < otherTarget)
+    advance(!algo1, otherTarget);
+  otherAtEnd = wasAtEnd;
+
+  (algo1 ? iterator1 : iterator2) = (algo1 ? qc1 : qc2)->begin();
+  (algo1 ? position1 : position2) = 0;
+  (algo1 ? atEnd1 : atEnd2)       = false;
+  while ((algo1 ? position1 : position2) < targetPos)
+    advance(algo1, targetPos);
+}
+
+/**Advances algo1 or algo2 as part of a multi-step move. If a segment whose
+ * functionality DD is built starts at the current position and ends at or
+ * before limit, the whole segment is applied with a single multiplication.
+ * Otherwise, this is a single batched stepForward.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ * @param limit position the move must not go beyond
+ * @return the number of operations that were applied
+ */
+unsigned int VerificationEngine::advance(const bool         algo1,
+                                         const unsigned int limit) {
+  auto& iterator = algo1 ? iterator1 : iterator2;
+  auto& position = algo1 ? position1 : position2;
+  auto& atEnd    = algo1 ? atEnd1 : atEnd2;
+
+  const SegmentCache::Segment* segment = nullptr;
+  if (segmentMatrices && !atEnd)
+    segment = (algo1 ? segments1 : segments2)->forward(position, limit);
+  if (segment == nullptr) {
+    stepForward(algo1, true);
+    return 1;
+  }
+
+  // algo1 is applied from the left, the inverse of algo2 from the right
+  auto measurement = measure(algo1, position, segment->end - position, false);
+  auto temp        = algo1 ? dd->multiply(segment->matrix, sim)
+                           : dd->multiply(sim, segment->inverse);
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(true);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+  const auto applied = segment->end - position;
+  iterator += static_cast<std::ptrdiff_t>(applied);
+  position = segment->end;
+  if (iterator == (algo1 ? qc1 : qc2)->end())
+    atEnd = true;
+  return applied;
+}
+
+/**Counterpart of advance that goes back to limit, reverting a whole segment
+ * at once if its inverse is built. Otherwise, this is a single batched
+ * stepBack.
+ *
+ * @return the number of operations that were reverted
+ */
+unsigned int VerificationEngine::retreat(const bool         algo1,
+                                         const unsigned int limit) {
+  auto& iterator = algo1 ? iterator1 : iterator2;
+  auto& position = algo1 ? position1 : position2;
+
+  const SegmentCache::Segment* segment = nullptr;
+  if (segmentMatrices && !(algo1 ? atInitial1 : atInitial2))
+    segment = (algo1 ? segments1 : segments2)->backward(position, limit);
+  if (segment == nullptr) {
+    stepBack(algo1, true);
+    return 1;
+  }
+
+  auto measurement =
+      measure(algo1, segment->start, position - segment->start, true);
+  auto temp = algo1 ? dd->multiply(segment->inverse, sim)
+                    : dd->multiply(sim, segment->matrix);
+  dd->incRef(temp);
+  dd->decRef(sim);
+  sim = temp;
+  measurement.lap(&Profiler::Sample::multiply);
+  collectGarbage(true);
+  measurement.lap(&Profiler::Sample::garbageCollect);
+  measurement.finish(dd->matrixMatrixMultiplication, sim);
+
+  const auto reverted = position - segment->start;
+  iterator -= static_cast<std::ptrdiff_t>(reverted);
+  position = segment->start;
+  return reverted;
+}
+
+/**Starts measuring a step of algo1 or algo2 that applies the operations from
+ * position on (see Profiler).
+ */
+Profiler::Measurement VerificationEngine::measure(const bool         algo1,
+                                                  const unsigned int position,
+                                                  const unsigned int operations,
+                                                  const bool inverse) {
+  const auto& qc = algo1 ? qc1 : qc2;
+  return profiler.measure(dd->matrixMatrixMultiplication, position, operations,
+                          qc->at(position)->getType(), inverse, algo1);
+}
+
+/**Gives the package the chance to collect garbage. Single steps do so after
+ * every operation, while multi-step moves only do so every BATCH_GC_INTERVAL
+ * operations, so consecutive operations of a batch can reuse the compute
+ * table entries of each other.
+ *
+ * @param batched whether the calling step is part of a multi-step move
+ */
+void VerificationEngine::collectGarbage(const bool batched) {
+  if (batched && ++uncollectedSteps < BATCH_GC_INTERVAL)
+    return;
+  uncollectedSteps = 0;
+  dd->garbageCollect();
+}
+
+/**Collects the garbage a multi-step move left behind (if any).
+ */
+void VerificationEngine::finishBatch() {
+  if (uncollectedSteps > 0)
+    collectGarbage(false);
+}
+
+/**Tries to import the passed algorithm and throws if it is not valid.
+ * Additionally some operations/DDs can be applied or just the iterator
+ * advance forward without applying operations/DDs.
+ *
+ * @param algo the algorithm to import; it is kept by the engine, so callers
+ * that no longer need the text should move it in
+ * @param formatCode format of the algorithm (1 = QASM, 2 = Real)
+ * @param opNum number of operations to step forward (may be bigger than the
+ * number of operations the algorithm has)
+ * @param process whether the operations should be processed or just the
+ * iterator needs to be advanced
+ * @param algo1 whether we load algo1 or algo2
+ * @return the number of operations of the loaded algorithm
+ */
+std::size_t VerificationEngine::load(std::string        algo,
+                                     const unsigned int formatCode,
+                                     unsigned int opNum, const bool process,
+                                     const bool algo1) {
+  auto&       oldQc      = algo1 ? qc1 : qc2;
+  const auto& otherQc    = algo1 ? qc2 : qc1;
+  const bool  otherReady = algo1 ? ready2 : ready1;
+
+  // the algorithm is imported into a new object, so the previous one stays
+  // intact until it has been reset and can be compared to the new one
+  std::unique_ptr<qc::QuantumComputation> newQc{};
+  try {
+    qc::Format format;
+    if (formatCode == 1)
+      format = qc::Format::OpenQASM3;
+    else if (formatCode == 2)
+      format = qc::Format::Real;
+    else
+      throw std::invalid_argument("Invalid format-code!");
+
+    newQc = CircuitCache::instance().import(algo, format);
+    // check if the number of qubits is the same for both algorithms
+    if (otherReady && newQc->getNqubits() != otherQc->getNqubits()) {
+      // the other algorithm is already loaded, so we reset this one
+      if (opCache) {
+        opCache->transfer(*oldQc, *newQc, 0);
+        (algo1 ? segments1 : segments2)->clear();
+      }
+      oldQc->reset();
+      (algo1 ? ready1 : ready2) = false;
+      std::stringstream msg;
+      msg << "Number of qubits don't match! This algorithm needs "
+          << otherQc->getNqubits() << " qubits.";
+      throw std::invalid_argument(msg.str());
+    }
+    acquirePackage(newQc->getNqubits());
+    // resize the DD package so that it can manage the current circuit size
+    dd->resize(newQc->getNqubits());
+  } catch (const std::invalid_argument&) {
+    throw;
+  } catch (const std::exception& e) {
+    std::cout << "Exception while loading the algorithm: " << e.what() << "\n";
+    throw;
+  }
+
+  // if sim hasn't been set yet or only one algorithm is loaded (meaning the
+  // other isn't ready), we create its initial state/matrix
+  if (sim.p == nullptr || (algo1 && !ready2) || (!algo1 && !ready1)) {
+    // sim = dd->makeZeroState(qc->getNqubits());
+    if (sim.p != nullptr)
+      dd->decRef(sim);
+    initialAncillary = newQc->ancillary;
+    sim              = dd->createInitialMatrix(initialAncillary);
+    dd->incRef(sim);
+
+  } else { // reset the previously loaded algorithm if process is true
+    if (process) {
+      try {
+        if (algo1 && ready1)
+          stepToStart(true);
+        else if (!algo1 && ready2)
+          stepToStart(false);
+      } catch (const std::exception& e) {
+        std::cout << "Exception while resetting algo" << (algo1 ? "1" : "2")
+                  << e.what() << std::endl;
+        std::string err(e.what());
+        throw std::runtime_error(
+            "Something went wrong with resetting the old algorithm.\n"
+            "Please try to load the algorithm again!" +
+            err);
+      }
+    }
+  }
+
+  // the cached DDs of the operations the edit left unchanged stay valid
+  const auto unchanged = unchangedOperations(*oldQc, *newQc);
+  opCache->transfer(*oldQc, *newQc, unchanged);
+  if (segmentMatrices)
+    (algo1 ? segments1 : segments2)->rebuild(*newQc, unchanged);
+  oldQc = std::move(newQc);
+  // the positions of the recorded steps refer to the previous circuit
+  profiler.clear();
+
+  // re-initialize some variables (though depending on opNum they might change
+  // in the next lines)
+  if (algo1) {
+    ready1     = true;
+    atInitial1 = true;
+    atEnd1     = false;
+    iterator1  = qc1->begin();
+    position1  = 0;
+    algorithm1 = std::move(algo);
+    format1    = formatCode;
+  } else {
+    ready2     = true;
+    atInitial2 = true;
+    atEnd2     = false;
+    iterator2  = qc2->begin();
+    position2  = 0;
+    algorithm2 = std::move(algo);
+    format2    = formatCode;
+  }
+
+  if (algo1 && opNum > qc1->getNops())
+    opNum = static_cast<unsigned int>(qc1->getNops());
+  else if (!algo1 && opNum > qc2->getNops())
+    opNum = static_cast<unsigned int>(qc2->getNops());
+
+  if (opNum > 0) {
+    if (algo1)
+      atInitial1 = false;
+    else
+      atInitial2 = false;
+    if (process) {
+      // apply some operations
+      while ((algo1 ? position1 : position2) < opNum)
+        advance(algo1, opNum);
+      finishBatch();
+
+    } else {
+      if (algo1) {
+        // just advance the iterator so it points to the operations where we
+        // stopped before the edit
+        for (unsigned int i = 0; i < opNum; i++)
+          iterator1++;
+        position1 = opNum;
+      } else {
+        // just advance the iterator so it points to the operations where we
+        // stopped before the edit
+        for (unsigned int i = 0; i < opNum; i++)
+          iterator2++;
+        position2 = opNum;
+      }
+    }
+  }
+
+  return algo1 ? qc1->getNops() : qc2->getNops();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Removes all applied operations by taking steps back until atInitial is true.
+ * atInitial will be true and in most cases atEnd will be false (special case
+ * for empty algorithms: atEnd is also true) after this call.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ * @return true if the DD changed, false otherwise (nothing was done or an error
+ * occurred)
+ */
+bool VerificationEngine::toStart(const bool algo1) {
+  if (algo1) {
+    if (!ready1) {
+      std::cout << "not ready 1" << std::endl;
+      return false;
+    } else if (qc1->empty()) {
+      std::cout << "empty 2" << std::endl;
+      return false;
+    } else if (atInitial1) {
+      std::cout << "at initial 2" << std::endl;
+      return false; // nothing changed
+    }
+
+    atEnd1 = false; // now we are definitely not at the end (if there were no
+                    // operation, so atInitial
+    // and atEnd could be true at the same time, if(qc-empty) would already have
+    // returned
+
+  } else {
+    if (!ready2) {
+      std::cout << "not ready 2" << std::endl;
+      return false;
+    } else if (qc2->empty()) {
+      std::cout << "empty 2" << std::endl;
+      return false;
+    } else if (atInitial2) {
+      std::cout << "atInitial 2" << std::endl;
+      return false; // nothing changed
+    }
+
+    atEnd2 = false; // now we are definitely not at the end (if there were no
+                    // operation, so atInitial
+    // and atEnd could be true at the same time, if(qc-empty) would already have
+    // returned
+  }
+
+  try {
+    stepToStart(algo1);
+    return true; // something changed
+
+  } catch (const std::exception& e) {
+    std::cout << "Exception while going back to the start!" << std::endl;
+    std::cout << e.what() << std::endl;
+    return false; // nothing changed
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Goes back to the previous step of the simulation process by applying the
+ * inverse of the last processed operation/DD. If atInitial is true, nothing
+ * happens instead. atEnd will be false and atInitial could end up being true,
+ * depending on the position.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ */
+VerificationEngine::StepResult VerificationEngine::prev(const bool algo1) {
+  StepResult result{};
+  if (algo1) {
+    if (!ready1) {
+      throw std::runtime_error("No algorithm loaded as algo1!");
+    } else if (qc1->empty()) {
+      return result;
+    }
+
+    if (atEnd1) {
+      atEnd1 = false;
+    } else if (atInitial1) {
+      return result; // we can't go any further back
+    }
+  } else {
+    if (!ready2) {
+      throw std::runtime_error("No algorithm loaded as algo2!");
+    } else if (qc2->empty()) {
+      return result;
+    }
+
+    if (atEnd2) {
+      atEnd2 = false;
+    } else if (atInitial2) {
+      return result; // we can't go any further back
+    }
+  }
+
+  try {
+    result.changed = true; // something changed
+    stepBack(algo1); // go back to the start before the last processed operation
+  } catch (const std::exception& e) {
+    std::cout << "Exception while getting the current operation {src: prev}!"
+              << e.what() << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Goes forward to the next step of the simulation process by applying the
+ * current operation/DD. If atEnd is true, nothing happens instead. atInitial
+ * will be false and atEnd could end up being true, depending on the position.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ */
+VerificationEngine::StepResult VerificationEngine::next(const bool algo1) {
+  StepResult result{};
+  if (algo1) {
+    if (!ready1) {
+      throw std::runtime_error("No algorithm loaded as algo1!");
+    } else if (qc1->empty()) {
+      return result;
+    }
+
+    if (atInitial1) {
+      atInitial1 = false;
+    } else if (atEnd1) {
+      return result;
+    }
+  } else {
+    if (!ready2) {
+      throw std::runtime_error("No algorithm loaded as algo2!");
+    } else if (qc2->empty()) {
+      return result;
+    }
+
+    if (atInitial2) {
+      atInitial2 = false;
+    } else if (atEnd2) {
+      return result;
+    }
+  }
+
+  try {
+    result.changed = true;
+    stepForward(algo1); // process the next operation
+    auto& iterator = algo1 ? iterator1 : iterator2;
+    auto& qc       = algo1 ? qc1 : qc2;
+    if (iterator != qc->end() && ((*iterator)->getType() == qc::Measure ||
+                                  (*iterator)->getType() == qc::Reset)) {
+      result.nextIsIrreversible = true;
+    }
+  } catch (const std::exception& e) {
+    std::cout << "Exception while getting the current operation {src: next}!"
+              << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Processes all operations until the iterator points to the very end.
+ * atEnd will be true and in most cases atInitial will be false (special case
+ * for empty algorithms: atInitial is also true) after this call.
+ *
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ */
+VerificationEngine::ToEndResult VerificationEngine::toEnd(const bool algo1) {
+  ToEndResult result{};
+  if (algo1) {
+    if (!ready1) {
+      throw std::runtime_error("No algorithm loaded as algo1!");
+    } else if (qc1->empty() || atEnd1) {
+      return result;
+    }
+    atInitial1 = false; // now we are definitely not at the beginning (if there
+                        // were no operation, so atInitial
+    // and atEnd could be true at the same time, if(qc-empty) would already have
+    // returned
+
+  } else {
+    if (!ready2) {
+      throw std::runtime_error("No algorithm loaded as algo2!");
+    } else if (qc2->empty() || atEnd2) {
+      return result;
+    }
+    atInitial2 = false; // now we are definitely not at the beginning (if there
+                        // were no operation, so atInitial
+                        //  and atEnd could be true at the same time,
+                        //  if(qc-empty) would already have returned
+  }
+
+  try {
+    result.changed = true; // something changed
+    auto& iterator = algo1 ? iterator1 : iterator2;
+    auto& atEnd    = algo1 ? atEnd1 : atEnd2;
+    while (!atEnd) {
+      if ((*iterator)->getType() == qc::Measure ||
+          (*iterator)->getType() == qc::Reset) {
+        result.nextIsIrreversible = true;
+        break;
+      } else if ((*iterator)->getType() == qc::Barrier) {
+        ++result.nops;
+        stepForward(algo1, true); // process the barrier
+        result.barrier = true;
+        break;
+      } else {
+        // process the next operation(s)
+        result.nops += advance(
+            algo1, static_cast<unsigned int>((algo1 ? qc1 : qc2)->getNops()));
+      }
+    }
+    finishBatch();
+  } catch (const std::exception& e) {
+    std::cout << "Exception while going to the end!" << std::endl;
+    std::cout << e.what() << std::endl;
+  }
+  return result;
+}
+
+/**Depending on the current position of the iterator and the given parameter
+ * this function either applies inverse operations/DDs like Prev or
+ * operations/DDs normally like Next, or rebuilds the functionality if that
+ * needs fewer multiplications (see seek). atInitial and atEnd could be anything
+ * after this call.
+ *
+ * @param targetPos position the iterator should point at after this call
+ * @param algo1 whether the function should be applied to algo1 or algo2
+ * @return true if the DD changed, false otherwise (nothing was done or an error
+ * occurred)
+ */
+bool VerificationEngine::toLine(unsigned int targetPos, const bool algo1) {
+  if (algo1) {
+    if (targetPos > qc1->getNops())
+      // we can't go further than to the end
+      targetPos = static_cast<unsigned int>(qc1->getNops());
+  } else {
+    if (targetPos > qc2->getNops())
+      // we can't go further than to the end
+      targetPos = static_cast<unsigned int>(qc2->getNops());
+  }
+
+  try {
+    if (algo1) {
+      if (position1 == targetPos)
+        return false; // nothing changed
+      seek(true, targetPos);
+
+      atInitial1 = false;
+      atEnd1     = false;
+      if (position1 == 0)
+        atInitial1 = true;
+      if (position1 == qc1->getNops())
+        atEnd1 = true;
+
+    } else {
+      if (position2 == targetPos)
+        return false; // nothing changed
+      seek(false, targetPos);
+
+      atInitial2 = false;
+      atEnd2     = false;
+      if (position2 == 0)
+        atInitial2 = true;
+      if (position2 == qc2->getNops())
+        atEnd2 = true;
+    }
+
+    return true; // something changed
+
+  } catch (const std::exception& e) {
+    std::stringstream ss{};
+    ss << "Exception while going from " << (algo1 ? position1 : position2)
+       << " to " << targetPos << ": " << e.what() << "\n";
+    const auto msg = ss.str();
+    std::cout << msg << std::endl;
+    throw std::runtime_error(msg);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Applies all remaining operations of both algorithms, interleaving the two
+ * circuits according to the given strategy. If both circuits are equivalent,
+ * the functionality stays close to the identity this way instead of growing to
+ * the full functionality of algo1 first, as it would with toEnd(true) followed
+ * by toEnd(false).
+ *
+ * @param strategy the order in which the operations are applied (Parallel
+ * builds both functionalities separately instead, see applyConcurrently)
+ * @return the number of operations that were applied of each algorithm
+ */
+VerificationEngine::CheckResult
+VerificationEngine::checkEquivalence(const Strategy strategy) {
+  if (!ready1 || !ready2)
+    throw std::runtime_error("Both algorithms need to be loaded!");
+  if (!unitaryFrom(*qc1, position1) || !unitaryFrom(*qc2, position2))
+    throw std::runtime_error("The automated check only supports circuits "
+                             "without measurements and resets!");
+
+  CheckResult result{};
+  if (strategy == Strategy::Parallel) {
+    result.nops1 = qc1->getNops() - position1;
+    result.nops2 = qc2->getNops() - position2;
+    applyConcurrently();
+  }
+
+  const auto nops1 = static_cast<unsigned long long>(qc1->getNops());
+  const auto nops2 = static_cast<unsigned long long>(qc2->getNops());
+  while (iterator1 != qc1->end() || iterator2 != qc2->end()) {
+    bool algo1 = iterator2 == qc2->end();
+    if (iterator1 == qc1->end() || iterator2 == qc2->end()) {
+      // only one algorithm has operations left
+    } else if (strategy == Strategy::Lookahead) {
+      ++(stepLookahead() ? result.nops1 : result.nops2);
+      continue;
+    } else if (strategy == Strategy::Proportional) {
+      // the algorithm that is relatively further behind goes next
+      algo1 = (position1 + 1ULL) * nops2 <= (position2 + 1ULL) * nops1;
+    } else {
+      algo1 = result.nops1 <= result.nops2;
+    }
+
+    stepForward(algo1, true);
+    ++(algo1 ? result.nops1 : result.nops2);
+  }
+  finishBatch();
+
+  if (result.nops1 > 0)
+    atInitial1 = false;
+  if (result.nops2 > 0)
+    atInitial2 = false;
+  result.changed     = result.nops1 + result.nops2 > 0;
+  result.equivalence = equivalence();
+  return result;
+}
+
+/**Builds the functionality of the remaining operations of algo1 and the
+ * inverse functionality of the remaining operations of algo2 concurrently, each
+ * on its own thread with its own package from the PackagePool, and applies
+ * both to the current functionality. The results are transferred to the
+ * package of the session by serializing them. Afterwards, both algorithms are
+ * at their end.
+ */
+void VerificationEngine::applyConcurrently() {
+  if (iterator1 == qc1->end() && iterator2 == qc2->end())
+    return;
+
+  const auto nqubits  = qc1->getNqubits();
+  auto       package1 = PackagePool::instance().acquire(nqubits, this);
+  PackagePool::PackagePtr package2{};
+  try {
+    package2 = PackagePool::instance().acquire(nqubits, this);
+  } catch (...) {
+    PackagePool::instance().release(std::move(package1));
+    throw;
+  }
+
+  std::stringstream  functionality1{};
+  std::stringstream  functionality2{};
+  std::exception_ptr error2{};
+  std::thread        worker{[&]() {
+    try {
+      serializeFunctionality(*qc2, position2, true, *package2, functionality2);
+    } catch (...) {
+      error2 = std::current_exception();
+    }
+  }};
+  std::exception_ptr error1{};
+  try {
+    serializeFunctionality(*qc1, position1, false, *package1, functionality1);
+  } catch (...) {
+    error1 = std::current_exception();
+  }
+  worker.join();
+  PackagePool::instance().release(std::move(package1));
+  PackagePool::instance().release(std::move(package2));
+  if (error1)
+    std::rethrow_exception(error1);
+  if (error2)
+    std::rethrow_exception(error2);
+
+  // algo1 is applied from the left, the inverse of algo2 from the right
+  const auto left  = dd->deserialize<dd::mNode>(functionality1, true);
+  const auto right = dd->deserialize<dd::mNode>(functionality2, true);
+  dd->incRef(left);
+  dd->incRef(right);
+  auto temp = dd->multiply(dd->multiply(left, sim), right);
+  dd->incRef(temp);
+  dd->decRef(sim);
+  dd->decRef(left);
+  dd->decRef(right);
+  sim = temp;
+  collectGarbage(false);
+
+  if (iterator1 != qc1->end()) {
+    iterator1 = qc1->end();
+    position1 = static_cast<unsigned int>(qc1->getNops());
+    atEnd1    = true;
+  }
+  if (iterator2 != qc2->end()) {
+    iterator2 = qc2->end();
+    position2 = static_cast<unsigned int>(qc2->getNops());
+    atEnd2    = true;
+  }
+}
+
+/**Compares the current functionality with the identity (or, if the circuits
+ * have ancillary qubits, with the initial functionality) without exporting it.
+ * The result only refers to the complete circuits if all operations of both
+ * algorithms have been applied (see complete).
+ *
+ * @param tolerance maximum deviation of an entry from the identity
+ */
+VerificationEngine::EquivalenceResult
+VerificationEngine::equivalence(const dd::fp tolerance) const {
+  if (!ready1 || !ready2)
+    throw std::runtime_error("Both algorithms need to be loaded!");
+
+  EquivalenceResult result{};
+  result.complete = iterator1 == qc1->end() && iterator2 == qc2->end();
+
+  IdentityCheck check{qc1->ancillary, tolerance};
+  const auto    factor = check.factor(sim);
+  if (factor.has_value() && std::abs(*factor - 1.) <= tolerance)
+    result.equivalence = Equivalence::Equivalent;
+  else if (factor.has_value() && std::abs(std::abs(*factor) - 1.) <= tolerance)
+    result.equivalence = Equivalence::EquivalentUpToGlobalPhase;
+  else
+    result.counterexample = check.counterexample(sim, qc1->getNqubits());
+  return result;
+}
+
+/**Simulates both algorithms on random input basis states and compares the
+ * resulting states. This is much cheaper than building the functionality and
+ * catches most non-equivalent circuits, but passing it does not prove the
+ * equivalence. The stimuli run in parallel on up to MAX_CHECK_WORKERS workers,
+ * each with its own package from the PackagePool, and the check stops at the
+ * first stimulus that leads to different states. Ancillary qubits are always
+ * zero in the inputs.
+ *
+ * @param stimuli number of random inputs to simulate (at most MAX_STIMULI)
+ * @param seed seed of the random inputs
+ */
+VerificationEngine::SimulationCheckResult
+VerificationEngine::simulationCheck(std::size_t         stimuli,
+                                    const std::uint64_t seed) const {
+  if (!ready1 || !ready2)
+    throw std::runtime_error("Both algorithms need to be loaded!");
+  if (!unitaryFrom(*qc1, 0) || !unitaryFrom(*qc2, 0))
+    throw std::runtime_error("The simulation check only supports circuits "
+                             "without measurements and resets!");
+  stimuli = std::min(stimuli, MAX_STIMULI);
+
+  // the inputs are drawn up front, so they do not depend on the scheduling
+  const auto                     nqubits = qc1->getNqubits();
+  std::mt19937_64                generator{seed};
+  std::bernoulli_distribution    bit{};
+  std::vector<std::vector<bool>> inputs(stimuli, std::vector<bool>(nqubits));
+  for (auto& input : inputs) {
+    for (std::size_t q = 0; q < nqubits; ++q)
+      input[q] = !qc1->ancillary[q] && bit(generator);
+  }
+
+  // every worker uses its own package: the first one is required, so a full
+  // pool is reported before any work is done, while further workers are only
+  // started if the pool has packages left (without evicting other sessions)
+  const auto workers = std::clamp<std::size_t>(
+      std::thread::hardware_concurrency(), 1,
+      std::clamp<std::size_t>(stimuli, 1, MAX_CHECK_WORKERS));
+  std::vector<PackagePool::PackagePtr> packages{};
+  packages.emplace_back(PackagePool::instance().acquire(nqubits, this));
+  try {
+    while (packages.size() < workers)
+      packages.emplace_back(PackagePool::instance().acquire(nqubits));
+  } catch (const std::runtime_error&) {
+    // the pool is exhausted, so fewer workers share the stimuli
+  }
+
+  SimulationCheckResult    result{};
+  std::mutex               resultMutex;
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool>        failed{false};
+  std::exception_ptr       error{};
+
+  const auto work = [&](dd::Package<>& package) {
+    try {
+      for (auto i = next++; i < stimuli && !failed; i = next++) {
+        const auto input = package.makeBasisState(nqubits, inputs[i]);
+        package.incRef(input);
+        const auto out1     = applyCircuit(*qc1, input, package);
+        const auto out2     = applyCircuit(*qc2, input, package);
+        const auto fidelity = package.fidelity(out1, out2);
+        package.decRef(input);
+        package.decRef(out1);
+        package.decRef(out2);
+        package.garbageCollect();
+
+        std::lock_guard guard{resultMutex};
+        ++result.stimuli;
+        result.fidelity = std::min(result.fidelity, fidelity);
+        if (fidelity < 1. - EQUIVALENCE_TOLERANCE && !failed) {
+          failed        = true;
+          result.passed = false;
+          auto& bits    = result.counterexample.emplace(nqubits, '0');
+          for (std::size_t q = 0; q < nqubits; ++q)
+            bits[nqubits - 1 - q] = inputs[i][q] ? '1' : '0';
+        }
+      }
+    } catch (...) {
+      std::lock_guard guard{resultMutex};
+      failed = true;
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t i = 1; i < packages.size(); ++i)
+    threads.emplace_back(work, std::ref(*packages[i]));
+  work(*packages.front());
+  for (auto& thread : threads)
+    thread.join();
+  for (auto& package : packages)
+    PackagePool::instance().release(std::move(package));
+
+  if (error)
+    std::rethrow_exception(error);
+  return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**Writes both loaded algorithms with their positions, the export options and
+ * the current functionality to the stream (see sessionfile).
+ */
+void VerificationEngine::save(std::ostream& os) const {
+  if (!isReady())
+    throw std::runtime_error("No algorithm has been loaded!");
+  sessionfile::writeHeader(os, sessionfile::Kind::Verification);
+
+  const auto writeAlgorithm = [&os](const bool ready, const std::string& algo,
+                                    const unsigned int format,
+                                    const unsigned int position) {
+    sessionfile::write<std::uint8_t>(os, ready ? 1 : 0);
+    if (!ready)
+      return;
+    sessionfile::write<std::uint32_t>(os, format);
+    sessionfile::writeString(os, algo);
+    sessionfile::write<std::uint32_t>(os, position);
+  };
+  writeAlgorithm(ready1, algorithm1, format1, position1);
+  writeAlgorithm(ready2, algorithm2, format2, position2);
+
+  std::uint8_t options = 0;
+  if (showColors)
+    options |= sessionfile::COLORED;
+  if (showEdgeLabels)
+    options |= sessionfile::EDGE_LABELS;
+  if (showClassic)
+    options |= sessionfile::CLASSIC;
+  if (usePolarCoordinates)
+    options |= sessionfile::POLAR;
+  sessionfile::write(os, options);
+
+  dd::serialize(sim, os, true);
+  if (!os)
+    throw std::runtime_error("Could not write the session!");
+}
+
+/**Restores a session written by save: the algorithms are imported again, but
+ * the functionality at the saved positions is read from the stream instead of
+ * being constructed. As in SimulationEngine::restore, the session is only
+ * replaced once the complete file has been checked.
+ *
+ * @throws std::runtime_error if the stream does not contain a valid session
+ */
+VerificationEngine::RestoreResult
+VerificationEngine::restore(std::istream& is) {
+  sessionfile::readHeader(is, sessionfile::Kind::Verification);
+  const auto readAlgorithm = [&is]() {
+    RestoredAlgorithm algorithm{};
+    algorithm.ready = sessionfile::read<std::uint8_t>(is) != 0;
+    if (algorithm.ready) {
+      algorithm.formatCode = sessionfile::read<std::uint32_t>(is);
+      algorithm.algo       = sessionfile::readString(is);
+      algorithm.position   = sessionfile::read<std::uint32_t>(is);
+    }
+    return algorithm;
+  };
+  RestoreResult result{};
+  result.algo1       = readAlgorithm();
+  result.algo2       = readAlgorithm();
+  const auto options = sessionfile::read<std::uint8_t>(is);
+  if (!result.algo1.ready && !result.algo2.ready)
+    throw std::runtime_error("The saved session is inconsistent!");
+
+  std::optional<std::size_t> nqubits{};
+  for (const auto* algorithm : {&result.algo1, &result.algo2}) {
+    if (!algorithm->ready)
+      continue;
+    if (algorithm->formatCode != 1 && algorithm->formatCode != 2)
+      throw std::runtime_error("The saved session is inconsistent!");
+    const auto savedQc = CircuitCache::instance().import(
+        algorithm->algo, algorithm->formatCode == 1 ? qc::Format::OpenQASM3
+                                                    : qc::Format::Real);
+    if (algorithm->position > savedQc->getNops() ||
+        (nqubits.has_value() && *nqubits != savedQc->getNqubits()))
+      throw std::runtime_error("The saved session is inconsistent!");
+    nqubits = savedQc->getNqubits();
+  }
+
+  const bool hadPackage = hasPackage();
+  acquirePackage(*nqubits);
+  dd::mEdge functionality{};
+  try {
+    functionality = sessionfile::readDD<dd::mNode>(is, *dd, *nqubits);
+  } catch (...) {
+    if (!hadPackage)
+      releasePackage();
+    throw;
+  }
+
+  // the algorithms are valid and their imports cached, so only now the loaded
+  // ones are replaced
+  try {
+    unready(true);
+    unready(false);
+    for (const bool algo1 : {true, false}) {
+      auto& algorithm = algo1 ? result.algo1 : result.algo2;
+      if (algorithm.ready)
+        algorithm.numOfOperations =
+            load(algorithm.algo, algorithm.formatCode, 0, true, algo1);
+    }
+  } catch (...) {
+    dd->decRef(functionality);
+    throw;
+  }
+  dd->decRef(sim);
+  sim = functionality;
+
+  if (result.algo1.ready) {
+    iterator1  = qc1->begin() + result.algo1.position;
+    position1  = result.algo1.position;
+    atInitial1 = position1 == 0;
+    atEnd1     = iterator1 == qc1->end();
+  }
+  if (result.algo2.ready) {
+    iterator2  = qc2->begin() + result.algo2.position;
+    position2  = result.algo2.position;
+    atInitial2 = position2 == 0;
+    atEnd2     = iterator2 == qc2->end();
+  }
+
+  showColors          = (options & sessionfile::COLORED) != 0;
+  showEdgeLabels      = (options & sessionfile::EDGE_LABELS) != 0;
+  showClassic         = (options & sessionfile::CLASSIC) != 0;
+  usePolarCoordinates = (options & sessionfile::POLAR) != 0;
+  return result;
+}
+
+/**Creates a DD in the .dot-format for the current state of the simulation.
+ *
+ * @return a string describing the current state of the simulation as DD in the
+ * .dot-format
+ */
+std::string VerificationEngine::getDD() const {
+  if (!ready1 && !ready2) {
+    throw std::runtime_error("No algorithm loaded!");
+  }
+
+  try {
+    return dotCache->get(sim, {showColors, showEdgeLabels, showClassic,
+                               usePolarCoordinates});
+
+  } catch (const std::exception& e) {
+    std::stringstream sserr{};
+    sserr << "Exception while getting the DD: " << e.what() << "\n";
+    sserr << "The values of the Flags are: " << this->showColors << ", "
+          << this->showEdgeLabels << ", " << this->showClassic << ", "
+          << this->usePolarCoordinates << "\n";
+    throw std::runtime_error(sserr.str());
+  }
+}
+
+/**Updates the fields of this object that determine with which options the
+ * DD should be exported (on the next getDD-call).
+ */
+void VerificationEngine::updateExportOptions(const bool colors,
+                                             const bool edgeLabels,
+                                             const bool classic,
+                                             const bool polar) {
+  this->showColors          = colors;
+  this->showEdgeLabels      = edgeLabels;
+  this->showClassic         = classic;
+  this->usePolarCoordinates = polar;
+}
+
+void VerificationEngine::unready(const bool algo1) {
+  if (algo1)
+    this->ready1 = false;
+  else
+    this->ready2 = false;
+}
+
+/**Enables or disables applying the functionality DDs of the measurement-free
+ * segments of both circuits in multi-step moves (see
+ * SimulationEngine::setSegmentMatrices).
+ */
+void VerificationEngine::setSegmentMatrices(const bool enabled) {
+  if (enabled == segmentMatrices)
+    return;
+  segmentMatrices = enabled;
+  if (!dd)
+    return; // the segments are computed once a circuit is loaded
+  if (segmentMatrices) {
+    segments1->rebuild(*qc1, 0);
+    segments2->rebuild(*qc2, 0);
+  } else {
+    segments1->clear();
+    segments2->clear();
+  }
+}
+
+/**Builds the functionality DD (and its inverse) of the next segment of algo1
+ * or, once those are done, of algo2 that does not have one yet.
+ *
+ * @return true if a segment was processed, false if there is nothing to do
+ */
+bool VerificationEngine::prepareSegment() {
+  if (!segmentMatrices || !dd)
+    return false;
+  return (ready1 && segments1->buildNext(*qc1)) ||
+         (ready2 && segments2->buildNext(*qc2));
+}
+
+/**Enables or disables recording the steps of both algorithms (see
+ * SimulationEngine::setProfiling).
+ */
+void VerificationEngine::setProfiling(const bool enabled) {
+  profiler.setEnabled(enabled);
+}
@@ -0,0 +1,255 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#ifndef QDD_VIS_VERIFICATIONENGINE_H
+#define QDD_VIS_VERIFICATIONENGINE_H
+
+#include "DotCache.h"
+#include "EngineLock.h"
+#include "OperationCache.h"
+#include "PackagePool.h"
+#include "Profiler.h"
+#include "SegmentCache.h"
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+
+/**Holds the state of a verification session and implements all stepping and
+ * export logic of QDDVer without depending on N-API, so it can be driven from
+ * worker threads. Callers have to hold the lock returned by lock() (or an
+ * owning one returned by tryLock()) while calling any other method.
+ */
+class VerificationEngine {
+public:
+  struct StepResult {
+    bool changed            = false;
+    bool nextIsIrreversible = false;
+  };
+  struct ToEndResult {
+    bool               changed            = false;
+    bool               nextIsIrreversible = false;
+    bool               barrier            = false;
+    unsigned long long nops               = 0;
+  };
+  // order in which checkEquivalence applies the operations of both circuits
+  enum class Strategy {
+    OneToOne,     // alternately one operation of each circuit
+    Proportional, // operations in proportion to the sizes of the circuits
+    Lookahead,    // the operation that results in the smaller DD
+    Parallel      // both functionalities separately and concurrently
+  };
+  enum class Equivalence {
+    Equivalent,
+    EquivalentUpToGlobalPhase,
+    NotEquivalent
+  };
+  struct EquivalenceResult {
+    Equivalence equivalence = Equivalence::NotEquivalent;
+    // whether all operations of both algorithms have been applied, i.e., the
+    // result refers to the complete circuits
+    bool complete = false;
+    // input basis state (qubit 0 is the rightmost character) that is not mapped
+    // to itself, only set if the algorithms are not equivalent
+    std::optional<std::string> counterexample{};
+  };
+  struct SimulationCheckResult {
+    // whether all stimuli led to the same state (which does not prove the
+    // equivalence of the algorithms)
+    bool        passed   = true;
+    std::size_t stimuli  = 0;  // number of simulated stimuli
+    dd::fp      fidelity = 1.; // lowest fidelity of the simulated stimuli
+    // input basis state (qubit 0 is the rightmost character) that led to
+    // different states
+    std::optional<std::string> counterexample{};
+  };
+  struct CheckResult {
+    bool               changed = false;
+    unsigned long long nops1   = 0; // operations applied of algo1
+    unsigned long long nops2   = 0; // operations applied of algo2
+    EquivalenceResult  equivalence{};
+  };
+  struct RestoredAlgorithm {
+    bool         ready           = false;
+    unsigned int formatCode      = 0;
+    unsigned int position        = 0;
+    std::size_t  numOfOperations = 0;
+    std::string  algo{};
+  };
+  struct RestoreResult {
+    RestoredAlgorithm algo1{};
+    RestoredAlgorithm algo2{};
+  };
+
+  // number of operations a multi-step move (toStart, toEnd, toLine, load)
+  // applies before the package gets the chance to collect garbage
+  static constexpr unsigned int BATCH_GC_INTERVAL = 32;
+  // default tolerance for comparing the functionality with the identity
+  static constexpr dd::fp EQUIVALENCE_TOLERANCE = 1e-8;
+  // default and maximum number of random stimuli of simulationCheck
+  static constexpr std::size_t DEFAULT_STIMULI = 8;
+  static constexpr std::size_t MAX_STIMULI     = 1U << 10U;
+  // upper bound for the number of packages simulationCheck takes from the
+  // PackagePool, so a single check cannot exhaust the pool other sessions use
+  static constexpr std::size_t MAX_CHECK_WORKERS = 4;
+
+  VerificationEngine();
+  ~VerificationEngine();
+
+  VerificationEngine(const VerificationEngine&)            = delete;
+  VerificationEngine& operator=(const VerificationEngine&) = delete;
+
+  using Lock = EngineLock<VerificationEngine>;
+
+  // blocks until the engine is idle, so it is meant for worker threads; the
+  // memory usage is measured when the lock is released
+  [[nodiscard]] Lock lock() { return Lock{*this, mutex}; }
+  // does not block; the returned lock does not own the mutex if it is busy
+  [[nodiscard]] std::unique_lock<std::mutex> tryLock() {
+    return std::unique_lock{mutex, std::try_to_lock};
+  }
+
+  std::size_t load(std::string algo, unsigned int formatCode,
+                   unsigned int opNum, bool process, bool algo1);
+  bool        toStart(bool algo1);
+  StepResult  prev(bool algo1);
+  StepResult  next(bool algo1);
+  ToEndResult toEnd(bool algo1);
+  bool        toLine(unsigned int targetPos, bool algo1);
+  CheckResult checkEquivalence(Strategy strategy);
+  [[nodiscard]] EquivalenceResult
+  equivalence(dd::fp tolerance = EQUIVALENCE_TOLERANCE) const;
+  [[nodiscard]] SimulationCheckResult
+  simulationCheck(std::size_t stimuli, std::uint64_t seed) const;
+  std::string getDD() const;
+
+  void          save(std::ostream& os) const;
+  RestoreResult restore(std::istream& is);
+
+  void updateExportOptions(bool colors, bool edgeLabels, bool classic,
+                           bool polar);
+  [[nodiscard]] bool getShowColors() const { return showColors; }
+  [[nodiscard]] bool getShowEdgeLabels() const { return showEdgeLabels; }
+  [[nodiscard]] bool getShowClassic() const { return showClassic; }
+  [[nodiscard]] bool getUsePolarCoordinates() const {
+    return usePolarCoordinates;
+  }
+
+  [[nodiscard]] bool isReady() const { return ready1 || ready2; }
+  [[nodiscard]] bool isReady(bool algo1) const {
+    return algo1 ? ready1 : ready2;
+  }
+  void unready(bool algo1);
+
+  void               setSegmentMatrices(bool enabled);
+  [[nodiscard]] bool getSegmentMatrices() const { return segmentMatrices; }
+  bool               prepareSegment();
+
+  void               setProfiling(bool enabled);
+  [[nodiscard]] bool getProfiling() const { return profiler.isEnabled(); }
+  // statistics of the steps recorded while profiling was enabled (JSON)
+  [[nodiscard]] std::string getStats() const { return profiler.toJson(); }
+
+  [[nodiscard]] MemoryUsage memoryUsage() const;
+  // usage measured by the last operation; does not require the lock
+  [[nodiscard]] MemoryUsage cachedMemoryUsage() const;
+  [[nodiscard]] bool        hasPackage() const { return dd != nullptr; }
+  void                      releasePackage();
+  // see SimulationEngine::setStreamedBytes
+  void setStreamedBytes(std::size_t bytes) { streamedBytes = bytes; }
+
+private:
+  friend Lock;
+  void finishOperation();
+
+  //"private" methods
+  // algo1: whether it is applied on algo1 or algo2, batched: whether the step
+  // is part of a multi-step move and may defer garbage collection
+  void stepForward(bool algo1, bool batched = false);
+  void stepBack(bool algo1, bool batched = false);
+  bool stepLookahead();
+  void stepToStart(bool algo1); // whether it is applied on algo1 or algo2
+  unsigned int advance(bool algo1, unsigned int limit);
+  unsigned int retreat(bool algo1, unsigned int limit);
+  unsigned int multiplications(bool algo1, unsigned int from,
+                               unsigned int to) const;
+  void seek(bool algo1, unsigned int targetPos);
+  void rebuild(bool algo1, unsigned int targetPos);
+  Profiler::Measurement measure(bool algo1, unsigned int position,
+                                unsigned int operations, bool inverse);
+  void collectGarbage(bool batched);
+  void finishBatch();
+  void acquirePackage(std::size_t nqubits);
+  void applyConcurrently();
+
+  // serializes all accesses to the DD package
+  std::mutex mutex;
+  // memory usage measured at the end of the last operation
+  std::atomic<std::size_t> usageNodes{0};
+  std::atomic<std::size_t> usageBytes{0};
+  std::atomic<std::size_t> streamedBytes{0};
+
+  // fields
+  // taken from the PackagePool on the first load
+  PackagePool::PackagePtr              dd;
+  std::unique_ptr<OperationCache>      opCache;
+  std::unique_ptr<SegmentCache>        segments1;
+  std::unique_ptr<SegmentCache>        segments2;
+  std::unique_ptr<DotCache<dd::mNode>> dotCache; // used by the const getDD
+  qc::MatrixDD                         sim{};
+  // ancillary qubits of the initial functionality, needed to rebuild it
+  std::vector<bool> initialAncillary{};
+  // sources of qc1 and qc2, kept for saving the session
+  std::string  algorithm1{};
+  unsigned int format1 = 0;
+  std::string  algorithm2{};
+  unsigned int format2 = 0;
+  // operations applied by the current batch since the last garbage collection
+  unsigned int uncollectedSteps = 0;
+  // whether multi-step moves apply the functionality DDs of whole segments
+  // (built in the background by prepareSegment)
+  bool segmentMatrices = false;
+  // records the durations of the single steps if enabled
+  Profiler profiler{};
+
+  // options for the DD export
+  bool showColors          = true;
+  bool showEdgeLabels      = true;
+  bool showClassic         = false;
+  bool usePolarCoordinates = true;
+
+  std::unique_ptr<qc::QuantumComputation> qc1;
+  std::vector<std::unique_ptr<qc::Operation>>::iterator
+               iterator1{};   // operations of algo1
+  unsigned int position1 = 0; // current position of iterator1
+
+  bool ready1 = false; // true if algo1 is valid
+  bool atInitial1 =
+      true; // whether we're currently before the first operation of algo1
+  bool atEnd1 =
+      false; // whether we're currently after the last operation of algo1
+
+  std::unique_ptr<qc::QuantumComputation> qc2;
+  std::vector<std::unique_ptr<qc::Operation>>::iterator
+               iterator2{};   // operations of algo2
+  unsigned int position2 = 0; // current position of iterator2
+
+  bool ready2 = false; // true if algo2 is valid
+  bool atInitial2 =
+      true; // whether we're currently before the first operation of algo2
+  bool atEnd2 =
+      false; // whether we're currently after the last operation of algo2
+};
+
+#endif // QDD_VIS_VERIFICATIONENGINE_H
@@ -4,14 +4,214 @@
  * for more information.
  */
 
+#include "AsyncTask.h"
+#include "CircuitCache.h"
+#include "PackagePool.h"
 #include "QDDVer.h"
 #include "QDDVis.h"
+#include "SessionRegistry.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <napi.h>
+#include <string>
+
+/**Reports how many DD packages of the shared pool are in use and kept.
+ *
+ * @return {inUse, idle, maxPackages, maxIdle, created, reused}
+ */
+Napi::Value GetPackagePoolOccupancy(const Napi::CallbackInfo& info) {
+  const auto occupancy = PackagePool::instance().occupancy();
+  auto       state     = Napi::Object::New(info.Env());
+  state.Set("inUse", Napi::Number::New(info.Env(), occupancy.inUse));
+  state.Set("idle", Napi::Number::New(info.Env(), occupancy.idle));
+  state.Set("maxPackages",
+            Napi::Number::New(info.Env(), occupancy.maxPackages));
+  state.Set("maxIdle", Napi::Number::New(info.Env(), occupancy.maxIdle));
+  state.Set("created", Napi::Number::New(info.Env(), occupancy.created));
+  state.Set("reused", Napi::Number::New(info.Env(), occupancy.reused));
+  return state;
+}
+
+/**Changes the limits of the shared DD package pool.
+ *
+ * @param info maxPackages (number), maxIdle (number)
+ */
+void SetPackagePoolLimits(const Napi::CallbackInfo& info) {
+  if (info.Length() != 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(info.Env(),
+                         "Arguments must be the maximum number of packages in "
+                         "use and the maximum number of kept packages!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  const auto maxPackages = info[0].As<Napi::Number>().Uint32Value();
+  const auto maxIdle     = info[1].As<Napi::Number>().Uint32Value();
+  PackagePool::instance().setLimits(maxPackages, maxIdle);
+}
+
+/**Reports how many parsed circuits are cached and how often loads could skip
+ * the parser.
+ *
+ * @return {entries, operations, hits, misses}
+ */
+Napi::Value GetCircuitCacheStats(const Napi::CallbackInfo& info) {
+  const auto stats = CircuitCache::instance().stats();
+  auto       state = Napi::Object::New(info.Env());
+  state.Set("entries", Napi::Number::New(info.Env(), stats.entries));
+  state.Set("operations", Napi::Number::New(info.Env(), stats.operations));
+  state.Set("hits", Napi::Number::New(info.Env(), stats.hits));
+  state.Set("misses", Napi::Number::New(info.Env(), stats.misses));
+  return state;
+}
+
+/**Checks that the only argument is the key of a session and throws a TypeError
+ * otherwise.
+ */
+static bool hasKeyArgument(const Napi::CallbackInfo& info) {
+  if (info.Length() != 1 || !info[0].IsString()) {
+    Napi::TypeError::New(info.Env(), "Argument must be the key of a session!")
+        .ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+/**Releases the packages of evicted sessions on a worker thread, since it waits
+ * for engines that are still busy.
+ */
+static void releaseEvictedSessions(Napi::Env env) {
+  if (!SessionRegistry::instance().releasePending())
+    return;
+  AsyncTask<bool>::Queue(
+      Napi::Object::New(env),
+      []() {
+        SessionRegistry::instance().releaseEvicted();
+        return true;
+      },
+      [](Napi::Env env, bool& /*released*/) -> Napi::Value {
+        return env.Undefined();
+      });
+}
+
+/**Marks the session as used. Evicts the sessions using the most memory if the
+ * memory budget is exceeded (see SessionRegistry).
+ *
+ * @param info key (string)
+ * @return false if the session does not exist (anymore), e.g., because it was
+ * evicted
+ */
+Napi::Value TouchSession(const Napi::CallbackInfo& info) {
+  if (!hasKeyArgument(info))
+    return info.Env().Null();
+  const auto key    = info[0].As<Napi::String>().Utf8Value();
+  const auto exists = SessionRegistry::instance().touch(key);
+  releaseEvictedSessions(info.Env());
+  return Napi::Boolean::New(info.Env(), exists);
+}
+
+/**Removes the session and releases its DD packages.
+ *
+ * @param info key (string)
+ * @return false if the session did not exist
+ */
+Napi::Value RemoveSession(const Napi::CallbackInfo& info) {
+  if (!hasKeyArgument(info))
+    return info.Env().Null();
+  const auto key     = info[0].As<Napi::String>().Utf8Value();
+  const auto removed = SessionRegistry::instance().remove(key);
+  releaseEvictedSessions(info.Env());
+  return Napi::Boolean::New(info.Env(), removed);
+}
+
+/**Evicts all sessions that have not been accessed for the given time.
+ *
+ * @param info maximum idle time in ms (number)
+ * @return the keys of the evicted sessions
+ */
+Napi::Value EvictIdleSessions(const Napi::CallbackInfo& info) {
+  if (info.Length() != 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(info.Env(), "Argument must be the idle time in ms!")
+        .ThrowAsJavaScriptException();
+    return info.Env().Null();
+  }
+  const std::chrono::milliseconds maxIdle{
+      info[0].As<Napi::Number>().Int64Value()};
+  const auto keys = SessionRegistry::instance().evictIdle(maxIdle);
+  releaseEvictedSessions(info.Env());
+
+  auto array = Napi::Array::New(info.Env(), keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    array.Set(static_cast<uint32_t>(i), Napi::String::New(info.Env(), keys[i]));
+  return array;
+}
+
+/**Changes the memory budget of all sessions, evicting sessions if necessary.
+ *
+ * @param info budget in bytes (number)
+ */
+void SetSessionMemoryBudget(const Napi::CallbackInfo& info) {
+  if (info.Length() != 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(info.Env(), "Argument must be the budget in bytes!")
+        .ThrowAsJavaScriptException();
+    return;
+  }
+  const auto bytes = info[0].As<Napi::Number>().Int64Value();
+  SessionRegistry::instance().setMemoryBudget(
+      static_cast<std::size_t>(std::max<int64_t>(bytes, 0)));
+  releaseEvictedSessions(info.Env());
+}
+
+/**Reports the memory usage of the sessions and how many have been evicted.
+ *
+ * @return {nodes, bytes, memoryBudget, evictedForMemory, evictedForPackages,
+ * evictedIdle, sessions: [{nodes, bytes, idle}]}, with the sessions ordered
+ * from the most to the least recently used and idle in ms
+ */
+Napi::Value GetSessionStats(const Napi::CallbackInfo& info) {
+  const auto env   = info.Env();
+  const auto stats = SessionRegistry::instance().stats();
+
+  auto sessions = Napi::Array::New(env, stats.sessions.size());
+  for (std::size_t i = 0; i < stats.sessions.size(); ++i) {
+    const auto& session = stats.sessions[i];
+    auto        entry   = Napi::Object::New(env);
+    entry.Set("nodes", Napi::Number::New(env, session.usage.nodes));
+    entry.Set("bytes", Napi::Number::New(env, session.usage.bytes));
+    entry.Set("idle", Napi::Number::New(
+                          env, static_cast<double>(session.idle.count())));
+    sessions.Set(static_cast<uint32_t>(i), entry);
+  }
+
+  auto state = Napi::Object::New(env);
+  state.Set("nodes", Napi::Number::New(env, stats.usage.nodes));
+  state.Set("bytes", Napi::Number::New(env, stats.usage.bytes));
+  state.Set("memoryBudget", Napi::Number::New(env, stats.memoryBudget));
+  state.Set("evictedForMemory", Napi::Number::New(env, stats.evictedForMemory));
+  state.Set("evictedForPackages",
+            Napi::Number::New(env, stats.evictedForPackages));
+  state.Set("evictedIdle", Napi::Number::New(env, stats.evictedIdle));
+  state.Set("sessions", sessions);
+  return state;
+}
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
   exports = QDDVis::Init(env, exports);
   exports = QDDVer::Init(env, exports);
+  exports.Set("getPackagePoolOccupancy",
+              Napi::Function::New(env, GetPackagePoolOccupancy));
+  exports.Set("setPackagePoolLimits",
+              Napi::Function::New(env, SetPackagePoolLimits));
+  exports.Set("touchSession", Napi::Function::New(env, TouchSession));
+  exports.Set("removeSession", Napi::Function::New(env, RemoveSession));
+  exports.Set("evictIdleSessions",
+              Napi::Function::New(env, EvictIdleSessions));
+  exports.Set("setSessionMemoryBudget",
+              Napi::Function::New(env, SetSessionMemoryBudget));
+  exports.Set("getSessionStats", Napi::Function::New(env, GetSessionStats));
+  exports.Set("getCircuitCacheStats",
+              Napi::Function::New(env, GetCircuitCacheStats));
   return exports;
 }
 
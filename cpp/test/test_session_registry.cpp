@@ -0,0 +1,110 @@
+/*
+ * This file is part of MQT DDVis library which is released under the MIT
+ * license. See file README.md or go to http://iic.jku.at/eda/research/quantum/
+ * for more information.
+ */
+
+#include "PackagePool.h"
+#include "SessionRegistry.h"
+#include "SimulationEngine.h"
+
+#include <cstddef>
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// format code of OpenQASM (see SimulationEngine::load)
+constexpr unsigned int QASM = 1;
+
+const std::string BELL = "OPENQASM 2.0;\n"
+                         "include \"qelib1.inc\";\n"
+                         "qreg q[2];\n"
+                         "h q[0];\n"
+                         "cx q[0], q[1];\n";
+
+void load(SimulationEngine& engine) {
+  const auto lock = engine.lock();
+  engine.load(BELL, QASM, 0, false);
+}
+
+bool hasPackage(SimulationEngine& engine) {
+  const auto lock = engine.lock();
+  return engine.hasPackage();
+}
+} // namespace
+
+/**The registry and the pool are process-wide, so every test limits the pool to
+ * two packages and removes its sessions again.
+ */
+class SessionRegistryTest : public testing::Test {
+protected:
+  static constexpr std::size_t MAX_PACKAGES = 2;
+
+  SessionRegistry&         registry = SessionRegistry::instance();
+  PackagePool&             pool     = PackagePool::instance();
+  std::vector<std::string> keys{"first", "second", "third"};
+
+  void SetUp() override { pool.setLimits(MAX_PACKAGES, 0); }
+
+  void TearDown() override {
+    for (const auto& key : keys)
+      registry.remove(key);
+    registry.releaseEvicted();
+    pool.setLimits(PackagePool::DEFAULT_MAX_PACKAGES,
+                   PackagePool::DEFAULT_MAX_IDLE);
+  }
+};
+
+TEST_F(SessionRegistryTest, NewSessionGetsPackageOfIdleSession) {
+  const auto first  = registry.simulation("first");
+  const auto second = registry.simulation("second");
+  load(*first);
+  load(*second);
+  ASSERT_EQ(pool.occupancy().inUse, MAX_PACKAGES);
+
+  const auto evicted = registry.stats().evictedForPackages;
+  const auto third   = registry.simulation("third");
+  ASSERT_NO_THROW(load(*third));
+  EXPECT_TRUE(hasPackage(*third));
+  EXPECT_EQ(pool.occupancy().inUse, MAX_PACKAGES);
+
+  // the least recently used session made room
+  EXPECT_FALSE(hasPackage(*first));
+  EXPECT_FALSE(registry.touch("first"));
+  EXPECT_TRUE(hasPackage(*second));
+  EXPECT_TRUE(registry.touch("second"));
+  EXPECT_EQ(registry.stats().evictedForPackages, evicted + 1);
+}
+
+TEST_F(SessionRegistryTest, BusySessionsKeepTheirPackages) {
+  const auto first  = registry.simulation("first");
+  const auto second = registry.simulation("second");
+  load(*first);
+  load(*second);
+
+  // keep both sessions busy on another thread, like running operations
+  std::promise<void> locked{};
+  std::promise<void> finished{};
+  std::thread        worker([&]() {
+    const auto firstLock  = first->lock();
+    const auto secondLock = second->lock();
+    locked.set_value();
+    finished.get_future().wait();
+  });
+  locked.get_future().wait();
+
+  const auto third = registry.simulation("third");
+  EXPECT_THROW(load(*third), std::runtime_error);
+  finished.set_value();
+  worker.join();
+
+  EXPECT_TRUE(hasPackage(*first));
+  EXPECT_TRUE(hasPackage(*second));
+  EXPECT_FALSE(hasPackage(*third));
+  EXPECT_TRUE(registry.touch("first"));
+  EXPECT_TRUE(registry.touch("second"));
+}
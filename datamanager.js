@@ -1,5 +1,11 @@
+const fs = require("fs");
+const path = require("path");
+const crypto = require("crypto");
 const qddVis = require("./build/Release/mqt-ddvis");
 
+const STATE_DIR = path.join(__dirname, "data"); //where /saveState puts the saved states
+const STATE_SECRET = crypto.randomBytes(32); //makes the ids of saved states unguessable from the session keys
+
 //const data = new Map(); //saves the QDDVis-objects needed for simulation
 
 class DataManager {
@@ -17,14 +23,14 @@ class DataManager {
   }
 
   addObject(key) {
+    //the objects of a session share their native state, which is managed (and possibly evicted) by the addon
     let obj;
-    if (this._objCode === 1) obj = new qddVis.QDDVer();
+    if (this._objCode === 1) obj = new qddVis.QDDVer(key);
     else obj = new qddVis.QDDVis(key);
 
     this._data.set(key, {
       //save:
       vis: obj, //the actual object needed for the simulation
-      last_access: _getTimeStamp(), //a time stamp to determine "old" entries that can be deleted safely
     });
   }
 }
@@ -82,12 +88,16 @@ function _createKey(req) {
   return ipPart + randPart;
 }
 
-/**Convenience function to get the current time.
+/**Removes the objects of the given session from every dataManager.
  *
- * @returns {number} a value representing the point in time the function was called at
+ * @param key the key of the session
+ * @private
  */
-function _getTimeStamp() {
-  return Date.now();
+function _removeKey(key) {
+  for (const item of manager) {
+    //item: [key, value]
+    item[1].data.delete(key);
+  }
 }
 
 /**Registers the requester by creating a QDDVis-object for them.
@@ -114,7 +124,8 @@ function register(req) {
 }
 
 /**Returns the QDDVis-object that is associated with the requester if one exists. (else null is returned)
- * Updates the last_access time-stamp since there was an interaction with the object.
+ * Marks the session as used, which may evict other sessions if the server runs out of memory. If the session itself
+ * has been evicted, its objects are removed and nothing is returned.
  *
  * @param req request of a client-call to the server
  * @returns {qddVis.QDDVis} or {qddVis.QDDVer} one of the objects associated with the requester
@@ -124,48 +135,95 @@ function get(req) {
   const dataManager = _getTargetManager(req);
   const item = dataManager.data.get(key);
   if (item) {
-    item.last_access = _getTimeStamp(); //update the last time the item was accessed
-    return item.vis;
+    if (qddVis.touchSession(key)) return item.vis;
+    _removeKey(key); //the session has been evicted
   }
 }
 
+/**Returns the id of the state the requester saves with /saveState. The id only depends on the session and on whether
+ * it is the simulation or the verification, so each of them keeps at most one saved state that is overwritten by the
+ * next save.
+ *
+ * @param req request of a client-call to the server
+ * @returns {string} 32 hexadecimal digits
+ */
+function stateId(req) {
+  return crypto
+    .createHmac("sha256", STATE_SECRET)
+    .update(_getTargetManager(req).objCode + ":" + _getKey(req))
+    .digest("hex")
+    .substr(0, 32);
+}
+
+/**Reports the occupancy of the pool of DD packages the QDDVis- and QDDVer-objects share.
+ * The objects only take a package from the pool once they load an algorithm.
+ *
+ * @returns {{inUse: number, idle: number, maxPackages: number, maxIdle: number, created: number, reused: number}}
+ */
+function packagePoolOccupancy() {
+  return qddVis.getPackagePoolOccupancy();
+}
+
+/**Reports the memory usage of the sessions and how many of them have been evicted.
+ *
+ * @returns {{nodes: number, bytes: number, memoryBudget: number, evictedForMemory: number,
+ *            evictedForPackages: number, evictedIdle: number, sessions: {nodes: number, bytes: number, idle: number}[]}}
+ */
+function sessionStats() {
+  return qddVis.getSessionStats();
+}
+
 //external scripts may only register/create and request/get objects
 module.exports.register = register;
 module.exports.get = get;
+module.exports.stateId = stateId;
+module.exports.packagePoolOccupancy = packagePoolOccupancy;
+module.exports.sessionStats = sessionStats;
 //allowing external removing may also make sense, but this isn't needed at the moment
 
 const CLEANUP_TIMER = 24 * 60 * 60 * 1000; //how much time passes between two cleanUPData()-calls - in ms (24 hours at the moment)
 const MAX_LAST_ACCESS_DIFF = CLEANUP_TIMER; //how much time must have passed since the last access before it will be deleted - in ms
-/**Cleans data by removing "old" entries. An entry is considered "old" if its last access was more than
- * MAX_LAST_ACCESS_DIFF ms in the past.
- * Logs the start of the process and its result (how many have been removed, how many remain).
+const MAX_STATE_AGE = 7 * CLEANUP_TIMER; //how long a saved state is kept after it has been written - in ms
+/**Cleans data by removing "old" sessions. A session is considered "old" if its last access was more than
+ * MAX_LAST_ACCESS_DIFF ms in the past. The addon keeps track of the accesses and releases the native state of the
+ * removed sessions right away.
+ * Logs the start of the process and its result (how many have been removed).
  *
  * @private no external scripts may interfere with the cleanup-process
  */
 function _cleanUpData() {
   console.log("Starting cleanup...");
 
-  const minLA = _getTimeStamp() - MAX_LAST_ACCESS_DIFF; //the min value of last_access for the item to not be
-  // removed; everything lower is removed
-  for (const entry of manager.entries()) {
-    //entry: [key, value]
-    const dm = entry[1];
-    //cleanup all dataManagers
-    const keysToRemove = []; //save the keys of the objects we want to remove because we
-    // can't alter the map while iterating it
-    for (const item of dm.data.entries()) {
-      //item: [key, value]
-      if (item[1].last_access < minLA) {
-        keysToRemove.push(item[0]);
+  const keysToRemove = qddVis.evictIdleSessions(MAX_LAST_ACCESS_DIFF);
+  for (const key of keysToRemove) _removeKey(key);
+  _cleanUpStates().catch((err) => console.log("Cleanup of saved states failed: " + err.message));
+
+  setTimeout(() => _cleanUpData(), CLEANUP_TIMER); //call the function again at a later time
+  console.log("Cleanup finished. Removed " + keysToRemove.length + " sessions.");
+}
+
+/**Deletes the states saved by /saveState (and leftovers of interrupted saves) that have been written more than
+ * MAX_STATE_AGE ms ago. Logs how many have been deleted.
+ *
+ * @private no external scripts may interfere with the cleanup-process
+ */
+async function _cleanUpStates() {
+  const now = Date.now();
+  let removed = 0;
+  for (const file of await fs.promises.readdir(STATE_DIR)) {
+    if (!file.endsWith(".qdds") && !file.endsWith(".qdds.tmp")) continue;
+    const filePath = path.join(STATE_DIR, file);
+    try {
+      const stats = await fs.promises.stat(filePath);
+      if (now - stats.mtimeMs > MAX_STATE_AGE) {
+        await fs.promises.unlink(filePath);
+        removed++;
       }
+    } catch (err) {
+      //the file has been deleted or replaced in the meantime
     }
-
-    //remove all "old" entries
-    for (const key of keysToRemove) dm.data.delete(key);
   }
-
-  setTimeout(() => _cleanUpData(), CLEANUP_TIMER); //call the function again at a later time
-  console.log("Cleanup finished."); // Removed " + keysToRemove.length + " items, " + data.size + " items remain.");
+  console.log("Removed " + removed + " saved states.");
 }
 //initiate the future cleanup
 setTimeout(() => _cleanUpData(), CLEANUP_TIMER);
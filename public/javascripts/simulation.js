@@ -749,7 +749,7 @@ function print(dd, callback, resetZoom = false) {
         .renderDot(dd.dot)
         .on("transitionStart", callback);
     }
-    plotAmplitudes(dd.amplitudes);
+    plotAmplitudes(dd.amplitudes, dd.indices, dd.nqubits);
   } else {
     graphviz.renderDot("digraph {}");
     amp_svg.style("visibility", "hidden");
@@ -821,14 +821,49 @@ function formatPhase(num) {
   }
 }
 
+/**Decodes the amplitudes sent by the server (base64 encoded raw bytes of little-endian 32-bit floats,
+ * real and imaginary part alternating).
+ */
+function decodeAmplitudes(amplitudes) {
+  return new Float32Array(decodeBytes(amplitudes).buffer);
+}
+
+/**Decodes the basis states of sparse amplitude exports sent by the server (base64 encoded raw bytes of little-endian
+ * 64-bit unsigned integers).
+ */
+function decodeIndices(indices) {
+  return new BigUint64Array(decodeBytes(indices).buffer);
+}
+
+function decodeBytes(base64) {
+  const raw = atob(base64);
+  const bytes = new Uint8Array(raw.length);
+  for (let i = 0; i < raw.length; i++) bytes[i] = raw.charCodeAt(i);
+  return bytes;
+}
+
 let current_namps = 0;
-function plotAmplitudes(amplitudes) {
-  if (amplitudes) {
+/**Plots the given amplitudes.
+ *
+ * @param amplitudes base64 encoded amplitudes (see decodeAmplitudes)
+ * @param indices [sparse and top-k exports only] base64 encoded basis states the amplitudes belong to
+ * @param nqubits number of qubits of the state
+ */
+function plotAmplitudes(amplitudes, indices, nqubits) {
+  if (typeof amplitudes === "string") {
+    // an empty string means the state has too many qubits to show amplitudes
     amp_svg.style("visibility", "visible");
     amp_descr.style("visibility", "hidden");
 
-    const amps = new Float32Array(JSON.parse(amplitudes));
+    const amps = decodeAmplitudes(amplitudes);
     const namps = amps.length / 2;
+    const stateIndices =
+      typeof indices === "string" ? decodeIndices(indices) : null;
+    const labelLength = stateIndices ? nqubits : Math.log2(namps);
+    const stateLabel = (i) =>
+      (stateIndices ? stateIndices[i] : i)
+        .toString(2)
+        .padStart(labelLength, "0");
 
     if (namps === 0) {
       amp_svg.style("visibility", "hidden");
@@ -849,7 +884,7 @@ function plotAmplitudes(amplitudes) {
 
     let binary_labels = [];
     for (var j = 0; j <= namps - 1; j++) {
-      binary_labels.push(j.toString(2).padStart(Math.log2(namps), "0"));
+      binary_labels.push(stateLabel(j));
     }
 
     yScale.domain(binary_labels).rangeRound([100, 0]);
@@ -917,8 +952,8 @@ function plotAmplitudes(amplitudes) {
       .duration(500)
       .call(d3.axisLeft(yScale));
 
-    if (namps !== current_namps) {
-      // number of amplitudes has changed -> redraw
+    if (namps !== current_namps || stateIndices) {
+      // number of amplitudes (or the shown basis states) has changed -> redraw
       // clear any previous rectangles
       amp_plot.selectAll("rect").remove();
       amp_plot
@@ -926,9 +961,7 @@ function plotAmplitudes(amplitudes) {
         .data(magnitudes)
         .enter()
         .append("rect")
-        .attr("y", (d, i) =>
-          yScale(i.toString(2).padStart(Math.log2(namps), "0")),
-        )
+        .attr("y", (d, i) => yScale(stateLabel(i)))
         .attr("width", (s) => xScale(s))
         .attr("height", yScale.bandwidth())
         .attr(
@@ -957,7 +990,7 @@ function plotAmplitudes(amplitudes) {
         const i = e.indexOf(event.currentTarget);
         amp_tooltip.html(
           "State: " +
-            i.toString(2).padStart(Math.log2(namps), "0") +
+            stateLabel(i) +
             '<div id="ampTooltipAmp">Amplitude: <b>' +
             formatAmplitude(d) +
             "</b></div>" +
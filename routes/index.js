@@ -1,4 +1,5 @@
 const fs = require("fs");
+const path = require("path");
 const express = require("express");
 const router = express.Router();
 const dm = require("../datamanager");
@@ -33,7 +34,7 @@ router.post("/register", (req, res) => {
  * Sends:   take a look at _sendDD documentation
  *
  */
-router.post("/load", (req, res) => {
+router.post("/load", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
     try {
@@ -44,9 +45,10 @@ router.post("/load", (req, res) => {
 
       const algo1 = req.body.algo1 === "true"; //needed to determine the algorithm of verification
 
-      const ret = vis.load(algo, format, opNum, reset, algo1); //algo1 only used for verification
+      const ret = await vis.loadAsync(algo, format, opNum, reset, algo1); //algo1 only used for verification
       if (ret.numOfOperations) {
-        _sendDD(res, vis.getDD(), ret);
+        _sendDD(res, await vis.getDDAsync(), ret);
+        _prepareSegments(vis);
       } else
         res.status(500).json({ msg: "Error while loading the algorithm!" });
     } catch (err) {
@@ -60,6 +62,58 @@ router.post("/load", (req, res) => {
   }
 });
 
+/**Same as /load, but the algorithm is streamed as the raw request body (e.g., Content-Type text/plain or
+ * application/octet-stream) instead of being part of a JSON or form body. The body is handed over to the native module
+ * chunk by chunk, so large algorithms are neither limited by the body parser nor copied as a whole into a JavaScript
+ * string. The received text counts towards the memory budget of the sessions, so other sessions may be evicted for it,
+ * and algorithms larger than the whole budget are rejected.
+ *
+ * Params (as query parameters): {
+ *     dataKey, opNum, format, reset, algo1: same as for /load
+ * }
+ * Sends:   take a look at _sendDD documentation
+ *
+ */
+router.post("/loadStream", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      const opNum = parseInt(req.query.opNum);
+      const format = parseInt(req.query.format);
+      const reset = req.query.reset === "true";
+      const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
+
+      vis.beginLoad();
+      await new Promise((resolve, reject) => {
+        req.on("data", (chunk) => {
+          try {
+            vis.pushChunk(chunk);
+          } catch (err) {
+            req.destroy();
+            reject(err);
+          }
+        });
+        req.on("end", resolve);
+        req.on("error", reject);
+      });
+
+      const ret = await vis.endLoadAsync(format, opNum, reset, algo1); //algo1 only used for verification
+      if (ret.numOfOperations) {
+        _sendDD(res, await vis.getDDAsync(), ret);
+        _prepareSegments(vis);
+      } else
+        res.status(500).json({ msg: "Error while loading the algorithm!" });
+    } catch (err) {
+      const retry = err.message.startsWith("Invalid algorithm!"); //if the algorithm is invalid, we need to send the last valid algorithm
+      res.status(400).json({ msg: err.message, retry: retry });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
 router.post("/reset", (req, res) => {
   const vis = dm.get(req);
   if (vis) {
@@ -68,8 +122,73 @@ router.post("/reset", (req, res) => {
       vis.unready(algo1);
       res.status(200).end();
     } catch (err) {
-      const retry = err.message.startsWith("Invalid algorithm!"); //if the algorithm is invalid, we need to send the last valid algorithm
-      res.status(400).json({ msg: err.message, retry: retry }); //I think retry is no longer needed!
+      _sendError(res, err, 400);
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Saves the current state of the requester's simulation (or verification) to a file in the data-directory, so it can
+ * be restored later, e.g., after the session expired or on a different server sharing the directory.
+ * Each session keeps one saved state for the simulation and one for the verification: saving again overwrites the
+ * previous state under the same id. Saved states are deleted a week after they have been written.
+ *
+ * Params: {
+ *     dataKey: the key that provides access to the QDDVis-object
+ *              received from the initial /register-call
+ * }
+ * Sends: {
+ *     id: the id needed to restore the state with /restoreState
+ * }
+ *
+ */
+router.post("/saveState", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      const id = dm.stateId(req);
+      await vis.saveStateAsync(_stateFile(id));
+      res.status(200).json({ id: id });
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Replaces the requester's simulation (or verification) with a state saved by /saveState and sends back its DD.
+ * The DD is read from the file instead of being computed again.
+ *
+ * Params: {
+ *     dataKey: the key that provides access to the QDDVis-object
+ *              received from the initial /register-call
+ *     id:      the id received from /saveState
+ * }
+ * Sends:   take a look at _sendDD documentation; data is {
+ *     [Simulation]   numOfOperations, nextIsIrreversible, noGoingBack, algo, format, position
+ *     [Verification] algo1, algo2: { ready, algo, format, position, numOfOperations }
+ * }
+ *
+ */
+router.post("/restoreState", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    const id = req.body.id;
+    if (typeof id !== "string" || !/^[0-9a-f]{32}$/.test(id)) {
+      res.status(400).json({ msg: "Invalid id of a saved state!" });
+      return;
+    }
+    try {
+      const ret = await vis.restoreStateAsync(_stateFile(id));
+      _sendDD(res, await vis.getDDAsync(), ret);
+    } catch (err) {
+      res.status(400).json({ msg: err.message });
     }
   } else {
     res.status(404).json({
@@ -86,10 +205,122 @@ router.post("/reset", (req, res) => {
  * Sends:   take a look at _sendDD documentation
  *
  */
-router.get("/getDD", (req, res) => {
+router.get("/getDD", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    _sendDD(res, vis.getDD());
+    try {
+      _sendDD(res, await vis.getDDAsync());
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Sends how the DD of the current simulation-state differs from the one sent by the previous call, so the requester can
+ * patch its copy instead of rendering the complete DD again.
+ *
+ * Params:  the key that provides access to the QDDVis-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ *          reset:  "true" if the requester has no previous DD, so the complete DD is sent
+ *
+ * Sends:   {
+ *     reset:   whether the diff is relative to an empty graph
+ *     root:    the root edge ({ target, re, im }; target 0 is the terminal)
+ *     added:   the new nodes ({ id, qubit, edges }), listed after the nodes they point to
+ *     changed: the nodes whose qubit or edges changed
+ *     removed: the ids of the nodes that are no longer part of the DD
+ * }
+ *
+ */
+router.get("/getDDDiff", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      const reset = req.query.reset === "true";
+      res.status(200).json(await vis.getDDDiffAsync(reset));
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Sends the DD of the current simulation-state as node and edge tables instead of DOT text (honouring the export
+ * options).
+ *
+ * Params:  the key that provides access to the QDDVis-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ * Sends:   {
+ *     nodeIds:     Uint32Array of the node ids (the terminal has id 0 and is not listed)
+ *     nodeQubits:  Int32Array of the qubits of the nodes
+ *     edgeSources: Uint32Array of the source ids of the edges (the first edge is the root edge with source 2^32-1)
+ *     edgeTargets: Uint32Array of the target ids of the edges
+ *     edgeIndices: Uint8Array of the successor index of each edge at its source
+ *     edgeWeights: Float64Array with two entries per edge, (re, im) or (magnitude, phase) if polar is set; empty if
+ *                  neither colors nor edge labels are shown
+ *     polar:       whether the weights are given in polar coordinates
+ * }
+ * all typed arrays are sent as base64 encoded raw (little-endian) bytes
+ *
+ */
+router.get("/getGraph", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      const graph = await vis.getGraphAsync();
+      res.status(200).json({
+        nodeIds: _encodeTypedArray(graph.nodeIds),
+        nodeQubits: _encodeTypedArray(graph.nodeQubits),
+        edgeSources: _encodeTypedArray(graph.edgeSources),
+        edgeTargets: _encodeTypedArray(graph.edgeTargets),
+        edgeIndices: _encodeTypedArray(graph.edgeIndices),
+        edgeWeights: _encodeTypedArray(graph.edgeWeights),
+        polar: graph.polar,
+      });
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Sends the amplitudes of the current simulation-state as raw binary data.
+ *
+ * Params:  the key that provides access to the QDDVis-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ * Sends:   the amplitudes as little-endian 32-bit floats (real and imaginary part alternating,
+ *          empty if the state has too many qubits) with content type application/octet-stream
+ *
+ */
+router.get("/amplitudes", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    if (!vis.getAmplitudesAsync) {
+      res.status(400).json({ msg: "Only available for simulation!" });
+      return;
+    }
+    try {
+      const state = await vis.getAmplitudesAsync();
+      res
+        .status(200)
+        .type("application/octet-stream")
+        .send(_typedArrayBuffer(state.amplitudes));
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -108,26 +339,159 @@ router.get("/getDD", (req, res) => {
  *     updateDD:    whether the DD should be sent back ("true") or not (others)
  * }
  * Sends:   take a look at _sendDD documentation
+ *          answers 409 if an operation of the requester is still running, the options are not changed then
+ *
+ */
+router.put("/updateExportOptions", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      const showColored = req.body.colored === "true";
+      const showEdgeLabels = req.body.edgeLabels === "true";
+      const showClassic = req.body.classic === "true";
+      const usePolarCoordinates = req.body.polar === "true";
+      const updateDD = req.body.updateDD === "true";
+
+      vis.updateExportOptions(
+        showColored,
+        showEdgeLabels,
+        showClassic,
+        usePolarCoordinates,
+      );
+
+      if (vis.isReady() && updateDD) _sendDD(res, await vis.getDDAsync());
+      else res.status(200).end(); //end the call without sending data
+    } catch (err) {
+      _sendError(res, err);
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Updates which amplitudes are sent along with the DD of the current simulation-state.
+ *
+ * Params:  {
+ *     dataKey:     the key that provides access to the QDDVis-object
+ *                  received from the initial /register-call
+ *     mode:        "dense" (all amplitudes), "sparse" (the nonzero amplitudes) or "topk" (the largest amplitudes)
+ *     limit:       [optional] maximum number of qubits for "dense", maximum number of amplitudes otherwise
+ *     updateDD:    whether the DD should be sent back ("true") or not (others)
+ * }
+ * Sends:   take a look at _sendDD documentation
+ *          answers 409 if an operation of the requester is still running, the options are not changed then
  *
  */
-router.put("/updateExportOptions", (req, res) => {
+router.put("/updateAmplitudeOptions", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const showColored = req.body.colored === "true";
-    const showEdgeLabels = req.body.edgeLabels === "true";
-    const showClassic = req.body.classic === "true";
-    const usePolarCoordinates = req.body.polar === "true";
-    const updateDD = req.body.updateDD === "true";
-
-    vis.updateExportOptions(
-      showColored,
-      showEdgeLabels,
-      showClassic,
-      usePolarCoordinates,
-    );
-
-    if (vis.isReady() && updateDD) _sendDD(res, vis.getDD());
-    else res.status(200).end(); //end the call without sending data
+    try {
+      const mode = req.body.mode;
+      const limit =
+        req.body.limit === undefined ? undefined : parseInt(req.body.limit);
+      const updateDD = req.body.updateDD === "true";
+
+      vis.updateAmplitudeOptions(mode, limit);
+
+      if (vis.isReady() && updateDD) _sendDD(res, await vis.getDDAsync());
+      else res.status(200).end(); //end the call without sending data
+    } catch (err) {
+      _sendError(res, err, 400);
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Enables or disables applying the functionality DDs of whole measurement-free segments of the loaded algorithm(s)
+ * when jumping (toEnd, toLine, load). The DDs are built in the background and reused by every later jump.
+ *
+ * Params:  {
+ *     dataKey:     the key that provides access to the QDDVis-object
+ *                  received from the initial /register-call
+ *     enabled:     "true" for true, others for false
+ * }
+ * Sends:   nothing
+ *          answers 409 if an operation of the requester is still running, the option is not changed then
+ *
+ */
+router.put("/segmentMatrices", (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      vis.setSegmentMatrices(req.body.enabled === "true");
+      _prepareSegments(vis);
+      res.status(200).end();
+    } catch (err) {
+      _sendError(res, err);
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Enables or disables recording the duration, the resulting DD size and the compute table hit ratio of every applied
+ * operation. Enabling discards the statistics recorded so far.
+ *
+ * Params:  {
+ *     dataKey:     the key that provides access to the QDDVis-object
+ *                  received from the initial /register-call
+ *     enabled:     "true" for true, others for false
+ * }
+ * Sends:   nothing
+ *          answers 409 if an operation of the requester is still running, the option is not changed then
+ *
+ */
+router.put("/profiling", (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      vis.setProfiling(req.body.enabled === "true");
+      res.status(200).end();
+    } catch (err) {
+      _sendError(res, err);
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Reports the statistics recorded while profiling was enabled (see /profiling).
+ *
+ * Params:  the key that provides access to the QDDVis-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ * Sends:   {
+ *     enabled:         whether profiling is enabled
+ *     steps:           number of recorded steps
+ *     hitRatio:        hit ratio of the multiplication compute table over all steps
+ *     time:            total duration of building the DDs of the operations, of the multiplications and of the garbage
+ *                      collections ({getDD, multiply, garbageCollect}, in microseconds)
+ *     histogram:       number of steps that took [2^i, 2^(i+1)) microseconds at index i
+ *     slowest:         the slowest steps, each with algo1, inverse, position, operations (more than one if a whole
+ *                      segment was applied), gate, getDD, multiply, garbageCollect, nodes (of the resulting DD) and
+ *                      hitRatio
+ *     largest:         the steps that resulted in the largest DDs (same format as slowest)
+ * }
+ *          answers 409 if an operation of the requester is still running
+ *
+ */
+router.get("/stats", (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    try {
+      res.status(200).type("json").send(vis.getStats());
+    } catch (err) {
+      _sendError(res, err);
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -138,8 +502,12 @@ router.put("/updateExportOptions", (req, res) => {
 router.get("/getExportOptions", (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const exportOptions = vis.getExportOptions();
-    res.status(200).json(exportOptions);
+    try {
+      const exportOptions = vis.getExportOptions();
+      res.status(200).json(exportOptions);
+    } catch (err) {
+      _sendError(res, err);
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -158,13 +526,17 @@ router.get("/getExportOptions", (req, res) => {
  *          may also send back a simple message if the simulation was already at the start and therefore nothing changed
  *
  */
-router.get("/tostart", (req, res) => {
+router.get("/tostart", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
-    const ret = vis.toStart(algo1); //algo1 only used for verification
-    if (ret) _sendDD(res, vis.getDD());
-    else res.status(403).json({ msg: "you were already at the start" }); //the client will search for res.svg, but it will be null so they won't redraw
+    try {
+      const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
+      const ret = await vis.toStartAsync(algo1); //algo1 only used for verification
+      if (ret) _sendDD(res, await vis.getDDAsync());
+      else res.status(403).json({ msg: "you were already at the start" }); //the client will search for res.svg, but it will be null so they won't redraw
+    } catch (err) {
+      _sendError(res, err);
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -184,20 +556,24 @@ router.get("/tostart", (req, res) => {
  *          was undone and nothing changed
  *
  */
-router.get("/prev", (req, res) => {
+router.get("/prev", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
-    const ret = vis.prev(algo1); //algo1 only used for verification
-    if (ret.changed)
-      _sendDD(res, vis.getDD(), {
-        noGoingBack: ret.noGoingBack,
-      });
-    //something changes so we update the shown dd
-    else
-      res
-        .status(403)
-        .json({ msg: "can't go back because we are at the beginning" }); //the client will search for res.svg, but it will be null so they won't redraw
+    try {
+      const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
+      const ret = await vis.prevAsync(algo1); //algo1 only used for verification
+      if (ret.changed)
+        _sendDD(res, await vis.getDDAsync(), {
+          noGoingBack: ret.noGoingBack,
+        });
+      //something changes so we update the shown dd
+      else
+        res
+          .status(403)
+          .json({ msg: "can't go back because we are at the beginning" }); //the client will search for res.svg, but it will be null so they won't redraw
+    } catch (err) {
+      _sendError(res, err);
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -217,19 +593,23 @@ router.get("/prev", (req, res) => {
  *          was applied and nothing changed
  *
  */
-router.get("/next", (req, res) => {
+router.get("/next", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
-    const ret = vis.next(algo1); //algo1 only used for verification
-
-    if (ret.changed) _sendDD(res, vis.getDD(), ret);
-    //something changes so we update the shown dd
-    else
-      res.send({
-        msg: "can't go ahead because we are at the end",
-        reload: "false",
-      });
+    try {
+      const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
+      const ret = await vis.nextAsync(algo1); //algo1 only used for verification
+
+      if (ret.changed) _sendDD(res, await vis.getDDAsync(), ret);
+      //something changes so we update the shown dd
+      else
+        res.send({
+          msg: "can't go ahead because we are at the end",
+          reload: "false",
+        });
+    } catch (err) {
+      _sendError(res, err);
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -237,25 +617,41 @@ router.get("/next", (req, res) => {
   }
 });
 
-router.get("/conductIrreversibleOperation", (req, res) => {
+/**Conducts the measurement or reset the simulation stopped at, with the outcome chosen by the user.
+ *
+ * Params:  the key that provides access to the QDDVis-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ *          parameter:  JSON-object with qubit, pzero, pone, classicalValueToMeasure, count, total and cbit (not set
+ *                      for resets), as sent along with the step that reached the operation
+ *
+ * Sends:   {dot, amplitudes, (indices, nqubits,) finished, (parameter of the next qubit if not finished)}
+ *
+ */
+router.get("/conductIrreversibleOperation", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    let data = JSON.parse(req.query.parameter);
-    const ret = vis.conductIrreversibleOperation(data);
-    const dd_ret = vis.getDD();
-    if (!ret.finished) {
-      res.status(200).json({
-        dot: dd_ret.dot,
-        amplitudes: JSON.stringify(Array.from(dd_ret.amplitudes)),
-        finished: ret.finished,
-        parameter: ret.parameter,
-      });
-    } else {
-      res.status(200).json({
+    if (!vis.conductIrreversibleOperationAsync) {
+      res.status(400).json({ msg: "Only available for simulation!" });
+      return;
+    }
+    try {
+      const data = JSON.parse(req.query.parameter);
+      const ret = await vis.conductIrreversibleOperationAsync(data);
+      const dd_ret = await vis.getDDAsync();
+      const result = {
         dot: dd_ret.dot,
-        amplitudes: JSON.stringify(Array.from(dd_ret.amplitudes)),
+        amplitudes: _encodeTypedArray(dd_ret.amplitudes),
         finished: ret.finished,
-      });
+      };
+      if (dd_ret.indices) {
+        result.indices = _encodeTypedArray(dd_ret.indices);
+        result.nqubits = dd_ret.nqubits;
+      }
+      if (!ret.finished) result.parameter = ret.parameter;
+      res.status(200).json(result);
+    } catch (err) {
+      _sendError(res, err, 400);
     }
   } else {
     res.status(404).json({
@@ -275,19 +671,144 @@ router.get("/conductIrreversibleOperation", (req, res) => {
  *          may also send back a simple message if the simulation was already at the end and therefore nothing changed
  *
  */
-router.get("/toend", (req, res) => {
+router.get("/toend", async (req, res) => {
   const vis = dm.get(req);
   if (vis) {
-    const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
-    const ret = vis.toEnd(algo1); //algo1 only used for verification
-    if (ret.changed)
-      _sendDD(res, vis.getDD(), {
-        nops: ret.nops,
-        nextIsIrreversible: ret.nextIsIrreversible,
-        barrier: ret.barrier,
-      });
-    //sendFile(res, data.ip); //something changes so we update the shown dd
-    else res.send({ msg: "you were already at the end", reload: "false" });
+    try {
+      const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
+      const ret = await vis.toEndAsync(algo1); //algo1 only used for verification
+      if (ret.changed)
+        _sendDD(res, await vis.getDDAsync(), {
+          nops: ret.nops,
+          nextIsIrreversible: ret.nextIsIrreversible,
+          barrier: ret.barrier,
+        });
+      //sendFile(res, data.ip); //something changes so we update the shown dd
+      else res.send({ msg: "you were already at the end", reload: "false" });
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Checks the equivalence of both loaded algorithms by applying all of their remaining operations, interleaving the two
+ * circuits according to the given strategy so the DD stays close to the identity for equivalent circuits.
+ *
+ * Params:  the key that provides access to the QDDVer-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ *          strategy:   [optional] "onetoone", "proportional" (default), "lookahead" or "parallel" (builds both
+ *                      functionalities concurrently, which is faster on multi-core machines if the circuits are
+ *                      not too large, but does not keep the intermediate DD close to the identity)
+ *
+ * Sends:   take a look at _sendDD documentation, additionally nops1 and nops2 (the number of applied operations of
+ *          algo1 and algo2) and equivalence (take a look at the /equivalence documentation)
+ *          may also send back a simple message if both algorithms were already at the end and therefore nothing changed
+ *
+ */
+router.get("/checkEquivalence", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    if (!vis.checkEquivalenceAsync) {
+      res.status(400).json({ msg: "Only available for verification!" });
+      return;
+    }
+    try {
+      const strategy = req.query.strategy || "proportional";
+      const ret = await vis.checkEquivalenceAsync(strategy);
+      if (ret.changed)
+        _sendDD(res, await vis.getDDAsync(), {
+          nops1: ret.nops1,
+          nops2: ret.nops2,
+          equivalence: ret.equivalence,
+        });
+      else res.send({ msg: "you were already at the end", reload: "false" });
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Reports whether the current functionality of the verification is the identity, without sending the DD.
+ *
+ * Params:  the key that provides access to the QDDVer-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ *          tolerance:  [optional] maximum deviation of an entry from the identity
+ *
+ * Sends:   {
+ *     equivalence:     "equivalent", "equivalent_up_to_global_phase" or "not_equivalent"
+ *     complete:        whether all operations of both algorithms have been applied
+ *     counterexample:  [only if not equivalent] input basis state that is not mapped to itself (qubit 0 rightmost)
+ * }
+ *
+ */
+router.get("/equivalence", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    if (!vis.getEquivalenceAsync) {
+      res.status(400).json({ msg: "Only available for verification!" });
+      return;
+    }
+    try {
+      const tolerance =
+        req.query.tolerance === undefined
+          ? undefined
+          : parseFloat(req.query.tolerance);
+      res.status(200).json(await vis.getEquivalenceAsync(tolerance));
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
+  } else {
+    res.status(404).json({
+      msg: "Your data is no longer available. Your page will be reloaded!",
+    });
+  }
+});
+
+/**Simulates both algorithms of the verification on random input basis states and compares the resulting states. This
+ * quickly detects most non-equivalent algorithms, but passing it does not prove their equivalence.
+ *
+ * Params:  the key that provides access to the QDDVer-object as query string ("?dataKey=...")
+ *          received from the initial /register-call
+ *
+ *          stimuli:    [optional] number of random inputs
+ *          seed:       [optional] seed for the random inputs
+ *
+ * Sends:   {
+ *     passed:          whether all inputs led to the same state
+ *     stimuli:         number of simulated inputs
+ *     fidelity:        lowest fidelity between the resulting states
+ *     counterexample:  [only if not passed] input basis state that led to different states (qubit 0 rightmost)
+ * }
+ *
+ */
+router.get("/simulationCheck", async (req, res) => {
+  const vis = dm.get(req);
+  if (vis) {
+    if (!vis.simulationCheckAsync) {
+      res.status(400).json({ msg: "Only available for verification!" });
+      return;
+    }
+    try {
+      const stimuli =
+        req.query.stimuli === undefined
+          ? undefined
+          : parseInt(req.query.stimuli);
+      const seed =
+        req.query.seed === undefined ? undefined : parseInt(req.query.seed);
+      res.status(200).json(await vis.simulationCheckAsync(stimuli, seed));
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -308,29 +829,33 @@ router.get("/toend", (req, res) => {
  *          was applied or undone, so nothing changed
  *
  */
-router.get("/toline", (req, res) => {
+router.get("/toline", async (req, res) => {
   const vis = dm.get(req);
   const line = parseInt(req.query.line);
   const algo1 = req.query.algo1 === "true"; //needed to determine the algorithm of verification
   if (vis) {
-    const ret = vis.toLine(line, algo1); //algo1 only used for verification
-    if (ret.changed)
-      _sendDD(res, vis.getDD(), {
-        nops: ret.nops,
-        nextIsIrreversible: ret.nextIsIrreversible,
-        noGoingBack: ret.noGoingBack,
-        reset: ret.reset,
-      });
-    //something changes so we update the shown dd
-    else
-      res.send({
-        msg: "you were already at line " + line,
-        reload: "false",
-        data: {
+    try {
+      const ret = await vis.toLineAsync(line, algo1); //algo1 only used for verification
+      if (ret.changed)
+        _sendDD(res, await vis.getDDAsync(), {
+          nops: ret.nops,
           nextIsIrreversible: ret.nextIsIrreversible,
           noGoingBack: ret.noGoingBack,
-        },
-      });
+          reset: ret.reset,
+        });
+      //something changes so we update the shown dd
+      else
+        res.send({
+          msg: "you were already at line " + line,
+          reload: "false",
+          data: {
+            nextIsIrreversible: ret.nextIsIrreversible,
+            noGoingBack: ret.noGoingBack,
+          },
+        });
+    } catch (err) {
+      res.status(500).json({ msg: err.message });
+    }
   } else {
     res.status(404).json({
       msg: "Your data is no longer available. Your page will be reloaded!",
@@ -394,27 +919,113 @@ router.get("/exampleAlgo", (req, res) => {
   res.status(404);
 });
 
+/**Reports the occupancy of the DD packages that are shared by all sessions.
+ *
+ * Params: none
+ * Sends: {
+ *      inUse       - number of packages currently held by sessions
+ *      idle        - number of packages kept for reuse
+ *      maxPackages - maximum number of packages in use at the same time
+ *      maxIdle     - maximum number of packages kept for reuse
+ *      created     - number of packages created since the server started
+ *      reused      - number of times a kept package was handed to a session
+ * }
+ */
+router.get("/packagePool", (req, res) => {
+  res.status(200).json(dm.packagePoolOccupancy());
+});
+
+/**Reports the memory usage of the sessions and how many of them have been evicted.
+ *
+ * Params: none
+ * Sends: {
+ *      nodes              - number of DD nodes referenced by all sessions
+ *      bytes              - memory occupied by these nodes
+ *      memoryBudget       - number of bytes the sessions may occupy before the largest ones are evicted
+ *      evictedForMemory   - number of sessions evicted to stay within the budget
+ *      evictedForPackages - number of idle sessions evicted because all DD packages were in use
+ *      evictedIdle        - number of sessions evicted because they were not used for a long time
+ *      sessions           - [{nodes, bytes, idle}] for each session, idle being the time since the last access in ms
+ * }
+ */
+router.get("/sessionStats", (req, res) => {
+  res.status(200).json(dm.sessionStats());
+});
+
 //####################################################################################################################################################################
 
 module.exports = router;
 
+/**Returns the path of the file a state with the given id is saved to.
+ *
+ * @param id the (validated) id of the saved state
+ * @returns {string} the path of the file in the data-directory
+ * @private
+ */
+function _stateFile(id) {
+  return path.join(__dirname, "..", "data", id + ".qdds");
+}
+
+/**Builds the functionality DDs of the segments of the loaded algorithm(s) in the background, if segment matrices are
+ * enabled for the given object (otherwise nothing is done). Failures are ignored since the DDs are only used to speed
+ * up jumps.
+ *
+ * @param vis the QDDVis- or QDDVer-object of the requester
+ * @private
+ */
+function _prepareSegments(vis) {
+  vis.prepareSegmentsAsync().catch(() => {});
+}
+
+/**Convenience function for reporting an error thrown by the QDDVis- or QDDVer-object to the requester. Synchronous
+ * methods do not wait for an operation of the same object that is still running on a worker thread but throw an error
+ * with code "EBUSY" instead, which is answered with 409 so the client can simply try again.
+ *
+ * @param res response-object needed to send something to the requester
+ * @param err the thrown error
+ * @param status the status to answer with for all other errors
+ * @private
+ */
+function _sendError(res, err, status = 500) {
+  res.status(err.code === "EBUSY" ? 409 : status).json({ msg: err.message });
+}
+
 /**Convenience function for sending the DD to the requester.
  *
  * @param res response-object needed to send something to the requester
- * @param dd string representation of the dd in .dot-format
+ * @param dd string representation of the dd in .dot-format and its amplitudes
  * @param data some optional data some of the callers of this function need to send along with the DD
  * @private
  */
 function _sendDD(res, dd, data) {
-  if (data || data === 0)
-    res.status(200).json({
-      dot: dd.dot,
-      amplitudes: JSON.stringify(Array.from(dd.amplitudes)),
-      data: data,
-    });
-  else
-    res.status(200).json({
-      dot: dd.dot,
-      amplitudes: JSON.stringify(Array.from(dd.amplitudes)),
-    });
+  const ret = {
+    dot: dd.dot,
+    amplitudes: _encodeTypedArray(dd.amplitudes),
+  };
+  if (dd.indices) {
+    //sparse and top-k exports also send the basis states of the amplitudes
+    ret.indices = _encodeTypedArray(dd.indices);
+    ret.nqubits = dd.nqubits;
+  }
+  if (data || data === 0) ret.data = data;
+  res.status(200).json(ret);
+}
+
+/**Creates a Buffer that shares its memory with the given typed array (no copy is made).
+ *
+ * @param array typed array returned by the native module, e.g., the amplitudes returned by getDD
+ * @private
+ */
+function _typedArrayBuffer(array) {
+  return Buffer.from(array.buffer, array.byteOffset, array.byteLength);
+}
+
+/**Encodes the raw bytes of the typed array as base64 so they can be embedded into the JSON response
+ * (amplitudes are decoded by plotAmplitudes in public/javascripts/simulation.js).
+ *
+ * @param array typed array returned by the native module, e.g., the amplitudes returned by getDD
+ * @private
+ */
+function _encodeTypedArray(array) {
+  return _typedArrayBuffer(array).toString("base64");
 }